@@ -52,6 +52,9 @@ struct Material {
 struct Renderable {
 
     ofMesh mesh;
+    // Set to a new process-wide value by markMeshChanged() after every write to mesh, so
+    // consumers such as the raytracer can skip rehashing an unchanged mesh. 0 means unknown.
+    uint64_t meshRevision{0};
     ofColor color{255, 255, 255};
     bool visible{true};
     bool showOutline{false};
@@ -74,4 +77,6 @@ struct Renderable {
     Renderable(const Renderable& other);
 
     Renderable& operator=(const Renderable& other);
+
+    void markMeshChanged();
 };
@@ -31,6 +31,7 @@
 #include "UI/ColorPanel.hpp"
 #include "UI/DelaunayPanel.hpp"
 #include "UI/SkyboxPanel.hpp"
+#include "UI/RaytracingPanel.hpp"
 #include "UI/InstructionsPanel.hpp"
 #include "UI/EventLogPanel.hpp"
 #include "UI/AssetsPanel.hpp"
@@ -84,6 +85,7 @@ struct UIContext {
     std::unique_ptr<ColorPanel> colorPanel;
     std::unique_ptr<DelaunayPanel> delaunayPanel;
     std::unique_ptr<SkyboxPanel> skyboxPanel;
+    std::unique_ptr<RaytracingPanel> raytracingPanel;
     std::unique_ptr<InstructionsPanel> instructionsPanel;
     std::unique_ptr<EventLogPanel> eventLogPanel;
     std::unique_ptr<AssetsPanel> assetsPanel;
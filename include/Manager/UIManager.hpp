@@ -2,6 +2,7 @@
 
 #include "UI/Toolbar.hpp"
 #include "UI/SkyboxPanel.hpp"
+#include "UI/RaytracingPanel.hpp"
 #include "UI/InstructionsPanel.hpp"
 #include "UI/EventLogPanel.hpp"
 #include "UI/ExportPanel.hpp"
@@ -35,6 +36,7 @@ class UIManager {
         void setupUI(
             Toolbar& toolbar,
             SkyboxPanel& skyboxPanel,
+            RaytracingPanel& raytracingPanel,
             InstructionsPanel& instructionsPanel,
             EventLogPanel& eventLogPanel,
             ExportPanel& exportPanel,
@@ -52,6 +54,7 @@ class UIManager {
 
         Toolbar* _toolbar;
         SkyboxPanel* _skyboxPanel;
+        RaytracingPanel* _raytracingPanel;
         InstructionsPanel* _instructionsPanel;
         EventLogPanel* _eventLogPanel;
         ExportPanel* _exportPanel;
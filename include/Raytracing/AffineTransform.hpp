@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Vec3.hpp"
+#include "Aabb.hpp"
+
+#include <glm/mat4x4.hpp>
+
+// Row-major 3x4 affine matrix, used to move rays and hits between world and object space.
+struct AffineTransform {
+    double m[3][4];
+
+    explicit AffineTransform(const glm::mat4& matrix = glm::mat4(1.0f));
+
+    Vec3 point(const Vec3& p) const;
+    Vec3 vector(const Vec3& v) const;
+    // Multiplies by the transposed 3x3 part. Applied to a world-to-object matrix it carries
+    // object-space normals to world space, keeping them perpendicular under non-uniform scale.
+    Vec3 normal(const Vec3& n) const;
+    // Determinant of the 3x3 part: how much the transform scales volumes.
+    double determinant() const;
+    // World bounds of an object-space box.
+    Aabb bounds(const Aabb& box) const;
+};
+
+inline Vec3 AffineTransform::point(const Vec3& p) const
+{
+    return Vec3(
+        m[0][0] * p.x() + m[0][1] * p.y() + m[0][2] * p.z() + m[0][3],
+        m[1][0] * p.x() + m[1][1] * p.y() + m[1][2] * p.z() + m[1][3],
+        m[2][0] * p.x() + m[2][1] * p.y() + m[2][2] * p.z() + m[2][3]
+    );
+}
+
+inline Vec3 AffineTransform::vector(const Vec3& v) const
+{
+    return Vec3(
+        m[0][0] * v.x() + m[0][1] * v.y() + m[0][2] * v.z(),
+        m[1][0] * v.x() + m[1][1] * v.y() + m[1][2] * v.z(),
+        m[2][0] * v.x() + m[2][1] * v.y() + m[2][2] * v.z()
+    );
+}
+
+inline Vec3 AffineTransform::normal(const Vec3& n) const
+{
+    return Vec3(
+        m[0][0] * n.x() + m[1][0] * n.y() + m[2][0] * n.z(),
+        m[0][1] * n.x() + m[1][1] * n.y() + m[2][1] * n.z(),
+        m[0][2] * n.x() + m[1][2] * n.y() + m[2][2] * n.z()
+    );
+}
@@ -2,42 +2,46 @@
 
 #include "Hittable.hpp"
 #include "HittableList.hpp"
+#include "WideBvh.hpp"
+#include "PrimitiveRef.hpp"
 #include "Aabb.hpp"
 
-#include <algorithm>
 #include <memory>
 #include <vector>
 
 class HittableList;
 
+// Top-level BVH over heterogeneous hittables, backed by a 4- or 8-wide WideBvh. Leaves
+// hold PrimitiveRefs in slot order, so known primitive kinds skip virtual dispatch.
+// Objects keep their index in the list they were built from, which is how they are
+// replaced and refitted afterwards; copies share the objects but not the tree.
 class Bvh : public Hittable {
     public:
-        Bvh(const HittableList& list);
-        Bvh(std::vector<std::shared_ptr<Hittable>>& objects, size_t start, size_t end);
+        Bvh(const HittableList& list, ThreadPool* threadPool = nullptr);
 
         bool hit(const Ray& r, Interval rayT, HitRecord& rec) const override;
+        bool occluded(const Ray& r, Interval rayT) const override;
         Aabb boundingBox() const override;
+        size_t nodeCount() const;
+        size_t nodeMemory() const;
+        const LinearBvh::BuildStats& buildStats() const;
 
-    private:
-        std::shared_ptr<Hittable> _left;
-        std::shared_ptr<Hittable> _right;
-        Aabb _bbox;
-
-        static Aabb _computeBoundingBox(
-            const std::vector<std::shared_ptr<Hittable>>& objects,
-            size_t start,
-            size_t end
-        );
+        size_t objectCount() const;
+        const std::shared_ptr<Hittable>& object(uint32_t index) const;
+        // Swaps the object at index; its bounds only count after the next refit().
+        void setObject(uint32_t index, std::shared_ptr<Hittable> object);
+        void refit(const std::vector<uint32_t>& changedObjects);
+        double sahGrowth() const;
 
-        static bool _boxCompare(
-            const std::shared_ptr<Hittable> a,
-            const std::shared_ptr<Hittable> b,
-            int axisIndex
-        );
+        // Takes over a tree built elsewhere over the current objects' bounds, in index order.
+        void setTree(WideBvh&& tree);
 
-        static bool _boxXCompare(const std::shared_ptr<Hittable> a, const std::shared_ptr<Hittable> b);
-        static bool _boxYCompare(const std::shared_ptr<Hittable> a, const std::shared_ptr<Hittable> b);
-        static bool _boxZCompare(const std::shared_ptr<Hittable> a, const std::shared_ptr<Hittable> b);
+    private:
+        std::vector<std::shared_ptr<Hittable>> _objects;
+        std::vector<PrimitiveRef> _slotPrimitives;
+        std::vector<uint32_t> _objectSlots;
+        WideBvh _tree;
+        Aabb _bbox;
 
-        static Aabb _getBox(const std::shared_ptr<Hittable>& obj);
+        void _linkSlots();
 };
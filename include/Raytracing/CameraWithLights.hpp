@@ -1,25 +1,92 @@
 #pragma once
 
 #include "Hittable.hpp"
-#include "Materials.hpp"
+#include "MaterialTable.hpp"
 #include "Lights.hpp"
 #include "SkyboxSampler.hpp"
+#include "ThreadPool.hpp"
+#include "Random.hpp"
+#include "Sampler.hpp"
 
 #include <vector>
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <thread>
-#include <vector>
+
+// PathByPath follows each sample's path to the end before starting the next one;
+// Wavefront traces all the samples of a tile together, one bounce at a time. Its extend and
+// shadow stages still traverse one ray at a time, so it is slower than PathByPath and is not
+// offered in the UI until the sorted queue is traversed as a stream.
+enum class TraceMode {
+    PathByPath,
+    Wavefront
+};
 
 class CameraWithLights {
     public:
+        struct Tile {
+            int x0, y0, x1, y1;
+        };
+
+        // Per-pixel sample statistics for adaptive sampling, indexed like the accumulation
+        // buffer divided by three (flipped image layout).
+        struct PixelStats {
+            std::vector<float> luminanceSquares;
+            std::vector<uint32_t> sampleCounts;
+
+            void reset(size_t pixelCount);
+        };
+
+        // Per-pixel sums of the first-hit albedo, normal (three floats each) and distance,
+        // laid out like the accumulation buffer, as guides for the denoiser.
+        struct AovBuffers {
+            std::vector<float> albedo;
+            std::vector<float> normal;
+            std::vector<float> depth;
+
+            void reset(size_t pixelCount);
+        };
+
+        // Optional inputs and outputs of renderTile().
+        struct TileContext {
+            const std::atomic<bool>* cancelled = nullptr;
+            // Enables adaptive sampling when adaptiveSampling is set.
+            PixelStats* stats = nullptr;
+            AovBuffers* aovs = nullptr;
+            uint64_t rays = 0;
+            uint64_t pixelsSampled = 0;
+        };
+
         void render(const Hittable& world, std::vector<unsigned char>& pixels);
 
+        // Adds samplesPerPixel samples per pixel to a linear RGB sum buffer, using sample
+        // indices starting at sampleOffset so successive calls keep refining the estimate.
+        void accumulate(const Hittable& world, std::vector<float>& accumulation, int sampleOffset);
+        void resolve(const std::vector<float>& accumulation, int sampleCount, std::vector<unsigned char>& pixels) const;
+
+        int imageHeight() const;
+
+        // Tile-level interface for callers that schedule the work themselves. prepareTiles()
+        // sets up the view for the current parameters and must be called first.
+        std::vector<Tile> prepareTiles();
+        // Returns false when cancelled part-way; the tile's sums are then incomplete.
+        // In adaptive mode, pixels whose estimate has converged are skipped.
+        bool renderTile(const Tile& tile, const Hittable& world, std::vector<float>& accumulation, int sampleOffset, TileContext* context = nullptr) const;
+        // Writes the tile's RGB bytes bottom row first, matching the flipped image layout.
+        // With stats, each pixel is divided by its own sample count, or shown as a heat map
+        // of that count relative to sampleCount when sampleHeatMap is set.
+        void resolveTile(const Tile& tile, const std::vector<float>& accumulation, int sampleCount, std::vector<unsigned char>& pixels, const PixelStats* stats = nullptr) const;
+
         double aspectRatio = 16.0 / 9.0;
         int imageWidth = 400;
         int samplesPerPixel = 10;
         int maxDepth = 10;
+        // Paths may be ended by Russian roulette once they have bounced this many times.
+        bool russianRoulette = true;
+        int rouletteMinDepth = 3;
 
         point3 lookFrom = point3(0, 0, 0);
         point3 lookAt = point3(0, 0, -1);
@@ -27,26 +94,60 @@ class CameraWithLights {
 
         double vfov = 90;
 
+        const MaterialTable* materials = nullptr;
         sceneLights* lights = nullptr;
         SkyboxSampler* skybox = nullptr;
 
+        ThreadPool* threadPool = nullptr;
+        int tileSize = 16;
+        uint64_t seed = 0;
+        SamplerType samplerType = SamplerType::Sobol;
+        TraceMode traceMode = TraceMode::PathByPath;
+
+        bool adaptiveSampling = false;
+        // Target standard error of a pixel's displayed (gamma-corrected) luminance, in 0-1
+        // display units; a pixel stops receiving samples once its estimate is below it.
+        double noiseThreshold = 0.01;
+        // Samples every pixel takes before its variance estimate is trusted.
+        int minAdaptiveSamples = 16;
+        bool sampleHeatMap = false;
+
     private:
+        friend class WavefrontTracer;
+
+        struct FirstHit {
+            Color albedo;
+            Vec3 normal;
+            double depth = 0.0;
+        };
+
         int _imageHeight;
         double _pixelSamplesScale;
         point3 _center;
         point3 _pixel00Loc;
         Vec3 _pixelDeltaU;
         Vec3 _pixelDeltaV;
+        // Angle one pixel subtends, in radians; the ray cone behind texture level selection.
+        double _pixelSpread;
         Vec3 _u, _v, _w;
 
         double _focusDist = 10.0;
 
         void _initialize();
-        Ray _getRay(int i, int j) const;
-        Vec3 _sampleSquare() const;
-        Color _rayColor(const Ray& r, int depth, const Hittable& world) const;
+        std::vector<Tile> _buildTiles() const;
+        Ray _getRay(int i, int j, Sampler& sampler) const;
+        Vec3 _sampleSquare(Sampler& sampler) const;
+        Color _rayColor(const Ray& cameraRay, const Hittable& world, uint64_t& rayCount, FirstHit* firstHit = nullptr) const;
+        Color _background(const Ray& r) const;
+        const Materials& _material(const HitRecord& rec) const;
+
+        bool _renderTileWavefront(const Tile& tile, const Hittable& world, std::vector<float>& accumulation, int sampleOffset, TileContext* context) const;
+        void _accumulatePixel(size_t pixel, const Color& color, double luminanceSquares, const FirstHit& hitSum, std::vector<float>& accumulation, PixelStats* stats, AovBuffers* aovs) const;
+        bool _converged(const float* sum, float luminanceSquares, uint32_t sampleCount) const;
 
-        static double _randomDouble();
+        static double _luminance(const Color& color);
+        static void _heatColor(double t, unsigned char* rgb);
         static double _degreesToRadians(double degrees);
         static double _linearToGamma(double linearComponent);
+        static unsigned char _toByte(float sum, double scale);
 };
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "ThreadPool.hpp"
+
+#include <vector>
+
+// Edge-avoiding a-trous wavelet filter for low sample count renders. The colour is divided
+// by the first-hit albedo so only the noisy lighting is blurred, then filtered with a
+// dilated 5x5 B3-spline kernel whose taps are weighted by how close their colour, normal
+// and depth are to the centre pixel.
+class Denoiser {
+    public:
+        // Per-pixel means in row-major order; color, albedo and normal hold three floats per
+        // pixel, depth one. A pixel without a surface has a zero normal and depth.
+        struct Frame {
+            int width = 0;
+            int height = 0;
+            std::vector<float> color;
+            std::vector<float> albedo;
+            std::vector<float> normal;
+            std::vector<float> depth;
+
+            void resize(int frameWidth, int frameHeight);
+        };
+
+        int iterations = 5;
+        // Colour sigma of the first pass, halved every pass so later, wider passes only
+        // merge lighting that is already close.
+        float colorSigma = 1.0f;
+        float normalSigma = 0.3f;
+        // Relative to the centre depth and the tap distance in pixels.
+        float depthSigma = 0.02f;
+
+        // Writes the filtered colour, three floats per pixel, into output. Rows are spread
+        // over pool when given; must not be called from a pool task.
+        void denoise(const Frame& frame, std::vector<float>& output, ThreadPool* pool = nullptr) const;
+
+    private:
+        void _filterRow(const Frame& frame, int y, int step, float colorSigma, const std::vector<float>& input, std::vector<float>& output) const;
+};
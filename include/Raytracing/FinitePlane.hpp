@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Hittable.hpp"
+#include "Vec3.hpp"
+#include "Aabb.hpp"
+#include "AffineTransform.hpp"
+
+#include <cstdint>
+#include <glm/mat4x4.hpp>
+
+// Rectangle in its local XY plane facing +z, intersected with a single plane test
+// instead of the two triangles of the plane mesh.
+class FinitePlane final : public Hittable {
+    public:
+        FinitePlane(const glm::mat4& objectToWorld, double halfWidth, double halfHeight, uint32_t material);
+
+        bool hit(const Ray& r, Interval rayT, HitRecord& rec) const override;
+        bool occluded(const Ray& r, Interval rayT) const override;
+        Aabb boundingBox() const override;
+        PrimitiveKind primitiveKind() const override;
+
+    private:
+        AffineTransform _objectToWorld;
+        AffineTransform _worldToObject;
+        double _halfWidth;
+        double _halfHeight;
+        uint32_t _material;
+        Vec3 _normal;
+        // The UV square stretched over the world-space rectangle.
+        double _uvDensity;
+        Aabb _bbox;
+
+        bool _intersect(const Ray& r, Interval rayT, double& t, point3& local) const;
+};
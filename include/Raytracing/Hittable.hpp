@@ -1,21 +1,37 @@
 #pragma once
 
-#include <memory>
+#include <cstdint>
 
 #include "Ray.hpp"
 #include "Interval.hpp"
 
-class Materials;
 class Aabb;
 
+// Concrete hittables that acceleration structures dispatch with a switch instead of a
+// virtual call; anything else reports Other and goes through the Hittable interface.
+enum class PrimitiveKind : uint8_t {
+    Other,
+    Mesh,
+    Sphere,
+    SphereSet,
+    Box,
+    Plane,
+    Instance
+};
+
+// material indexes the scene's MaterialTable. uvDensity is filled by the primitive (UV units
+// per world unit around p) and footprint by the integrator (world-space width of the pixel's
+// ray cone at p); texture filtering falls back to the full-resolution level while either is 0.
 struct HitRecord {
     point3 p;
     Vec3 normal;
-    std::shared_ptr<Materials> mat;
+    uint32_t material;
     double t;
     bool frontFace;
     double u;
     double v;
+    double uvDensity = 0.0;
+    double footprint = 0.0;
 
     void setFaceNormal(const Ray& r, const Vec3& outwardNormal);
 };
@@ -25,5 +41,10 @@ class Hittable {
         virtual ~Hittable() = default;
 
         virtual bool hit(const Ray& r, Interval rayT, HitRecord& rec) const = 0;
+
+        // Any-hit query for shadow rays: true as soon as something blocks r inside rayT.
+        // Falls back to a closest hit; accelerated hittables override it.
+        virtual bool occluded(const Ray& r, Interval rayT) const;
         virtual Aabb boundingBox() const = 0;
+        virtual PrimitiveKind primitiveKind() const;
 };
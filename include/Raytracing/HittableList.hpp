@@ -17,5 +17,6 @@ class HittableList : public Hittable {
         void add(std::shared_ptr<Hittable> object);
 
         bool hit(const Ray& r, Interval rayT, HitRecord& rec) const override;
+        bool occluded(const Ray& r, Interval rayT) const override;
         Aabb boundingBox() const override;
 };
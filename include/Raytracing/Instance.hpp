@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Hittable.hpp"
+#include "Aabb.hpp"
+#include "MaterialTable.hpp"
+#include "AffineTransform.hpp"
+#include "PrimitiveRef.hpp"
+
+#include <glm/mat4x4.hpp>
+#include <memory>
+
+// Places a shared object-space hittable in the world. Rays are moved into object space
+// for traversal and hits are moved back, so one bottom-level BVH serves every instance.
+class Instance final : public Hittable {
+    public:
+        Instance(std::shared_ptr<Hittable> object, const glm::mat4& objectToWorld, uint32_t material);
+
+        bool hit(const Ray& r, Interval rayT, HitRecord& rec) const override;
+        bool occluded(const Ray& r, Interval rayT) const override;
+        Aabb boundingBox() const override;
+        PrimitiveKind primitiveKind() const override;
+
+        const std::shared_ptr<Hittable>& object() const;
+
+    private:
+        std::shared_ptr<Hittable> _object;
+        PrimitiveRef _objectRef;
+        uint32_t _material;
+
+        AffineTransform _objectToWorld;
+        AffineTransform _worldToObject;
+        double _volumeScale;
+
+        Aabb _bbox;
+};
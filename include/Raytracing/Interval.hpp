@@ -11,17 +11,43 @@ using Color = Vec3;
 struct Interval {
     double min, max;
 
-    Interval();
-    Interval(double min, double max);
+    constexpr Interval();
+    constexpr Interval(double min, double max);
 
-    double size() const;
-    bool contains(double x) const;
-    bool surrounds(double x) const;
-    double clamp(double x) const;
+    constexpr double size() const;
+    constexpr bool contains(double x) const;
+    constexpr bool surrounds(double x) const;
+    constexpr double clamp(double x) const;
 
     static const Interval empty;
     static const Interval universe;
 };
 
+constexpr Interval::Interval() : min(+INFINITY), max(-INFINITY) {}
+
+constexpr Interval::Interval(double min, double max) : min(min), max(max) {}
+
+constexpr double Interval::size() const
+{
+    return this->max - this->min;
+}
+
+constexpr bool Interval::contains(double x) const
+{
+    return this->min <= x && x <= this->max;
+}
+
+constexpr bool Interval::surrounds(double x) const
+{
+    return this->min < x && x < this->max;
+}
+
+constexpr double Interval::clamp(double x) const
+{
+    if (x < this->min) return this->min;
+    if (x > this->max) return this->max;
+    return x;
+}
+
 double linearToGamma(double linearComponent);
 void writeColor(std::ostream& out, const Color& pixelColor);
@@ -10,6 +10,19 @@
 #include <vector>
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+
+// How sceneLights picks the lights evaluated at a shading point. All casts a shadow ray
+// to every light. Power draws lights from an alias table weighted by emitted power.
+// Resampled draws candidateCount lights that way, keeps one in proportion to its
+// unshadowed contribution (resampled importance sampling) and shadow-tests only that one,
+// which accounts for distance, falloff and the spot cone. Ambient lights are always added
+// directly since they need no shadow ray.
+enum class LightSampling {
+    All,
+    Power,
+    Resampled
+};
 
 struct RtLight {
     LightType type;
@@ -22,6 +35,9 @@ struct RtLight {
 
     RtLight(const LightSource& light, const glm::mat4& transform = glm::mat4(1.0f));
 
+    // Luminance of intensity times colour, used to weight light selection.
+    double power() const;
+
     Color computeLighting(
         const point3& hitPoint,
         const Vec3& normal,
@@ -30,13 +46,41 @@ struct RtLight {
         double shininess,
         const Hittable& world
     ) const;
+
+    // computeLighting without the shadow ray.
+    Color unshadowedLighting(
+        const point3& hitPoint,
+        const Vec3& normal,
+        const Vec3& viewDir,
+        const Color& albedo,
+        double shininess
+    ) const;
+
+    // Ray from hitPoint towards the light; tMax is where the light sits along it.
+    Ray shadowRay(const point3& hitPoint, double& tMax) const;
+    bool visible(const point3& hitPoint, const Hittable& world) const;
 };
 
 struct sceneLights {
+    // A selected light and its unshadowed contribution, already divided by the selection
+    // probability; it counts only if the light is visible from the shading point.
+    struct LightSample {
+        const RtLight* light;
+        Color contribution;
+    };
+
     std::vector<RtLight> lights;
 
+    LightSampling sampling = LightSampling::All;
+    // Lights (or reservoirs, when resampling) taken per shading point.
+    int lightSamples = 1;
+    int candidateCount = 8;
+
     void add(const RtLight& light);
     void clear();
+    // Rebuilds the alias table from lights; call after the last add(). Until then the
+    // sampled modes fall back to evaluating every light.
+    void buildSamplingTable();
     Color computeTotalLighting(
         const point3& hitPoint,
         const Vec3& normal,
@@ -45,4 +89,32 @@ struct sceneLights {
         double shininess,
         const Hittable& world
     ) const;
+    // computeTotalLighting with the shadow rays left to the caller: returns the part that
+    // needs none (ambient lights) and appends the light samples that do.
+    Color sampleLighting(
+        const point3& hitPoint,
+        const Vec3& normal,
+        const Vec3& viewDir,
+        const Color& albedo,
+        double shininess,
+        std::vector<LightSample>& samples
+    ) const;
+
+    private:
+        // Alias table over _sampledLights, the lights that need a shadow ray.
+        std::vector<uint32_t> _sampledLights;
+        std::vector<uint32_t> _ambientLights;
+        std::vector<double> _probability;
+        std::vector<uint32_t> _alias;
+        std::vector<double> _pdf;
+        size_t _tableLightCount = 0;
+
+        uint32_t _sampleLight(double& pdf) const;
+        // Calls emit(light, contribution) for each selected light and returns the ambient part.
+        template<typename Emit>
+        Color _selectLights(const point3& hitPoint, const Vec3& normal, const Vec3& viewDir, const Color& albedo, double shininess, Emit&& emit) const;
+        template<typename Emit>
+        void _selectByPower(const point3& hitPoint, const Vec3& normal, const Vec3& viewDir, const Color& albedo, double shininess, Emit&& emit) const;
+        template<typename Emit>
+        void _selectResampled(const point3& hitPoint, const Vec3& normal, const Vec3& viewDir, const Color& albedo, double shininess, Emit&& emit) const;
 };
@@ -0,0 +1,178 @@
+#pragma once
+
+#include "Hittable.hpp"
+#include "Aabb.hpp"
+#include "ThreadPool.hpp"
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+// 32-byte node of a BVH flattened in depth-first order. The first child of an interior
+// node is the next node in the array and offset holds the second one; a leaf stores
+// primitiveCount indices starting at offset in the primitive index array.
+struct LinearBvhNode {
+    float boundsMin[3];
+    float boundsMax[3];
+    uint32_t offset;
+    uint16_t primitiveCount;
+    uint8_t axis;
+    uint8_t pad;
+
+    bool isLeaf() const { return this->primitiveCount > 0; }
+};
+
+static_assert(sizeof(LinearBvhNode) == 32, "LinearBvhNode must stay 32 bytes");
+
+// Index-based BVH over an external array of primitives. It only knows primitive bounds;
+// owners keep their primitives in typed arrays and resolve leaf indices themselves.
+// Built with a binned surface area heuristic; large subtrees are built on a ThreadPool.
+class LinearBvh {
+    public:
+        struct BuildStats {
+            double buildMilliseconds = 0.0;
+            double sahCost = 0.0;
+            size_t nodeCount = 0;
+            size_t leafCount = 0;
+        };
+
+        void build(const std::vector<Aabb>& primitiveBounds, ThreadPool* threadPool = nullptr);
+        void clear();
+
+        bool empty() const;
+        Aabb bounds() const;
+        size_t nodeCount() const;
+        const std::vector<LinearBvhNode>& nodes() const;
+        const std::vector<uint32_t>& primitiveIndices() const;
+        const BuildStats& buildStats() const;
+
+        // Walks the tree front to back with an explicit stack. intersectPrimitive(index,
+        // rayT, rec) returns true when it finds a hit inside rayT and fills rec.
+        template <typename IntersectFn>
+        bool intersect(const Ray& r, Interval rayT, HitRecord& rec, IntersectFn&& intersectPrimitive) const;
+
+        static constexpr int maxLeafSize = 8;
+        static constexpr int maxDepth = 64;
+        static constexpr int binCount = 16;
+        static constexpr size_t parallelThreshold = 4096;
+
+        // SAH costs, relative to one primitive intersection.
+        static constexpr double traversalCost = 0.125;
+        static constexpr double intersectionCost = 1.0;
+
+    private:
+        struct BuildPrimitive {
+            Aabb bounds;
+            point3 centroid;
+            uint32_t index;
+        };
+
+        // Axis-aligned box that can start empty, unlike Aabb which pads itself on construction.
+        struct BinBounds {
+            double lo[3] = {INFINITY, INFINITY, INFINITY};
+            double hi[3] = {-INFINITY, -INFINITY, -INFINITY};
+
+            void grow(const Aabb& box);
+            void grow(const point3& p);
+            void grow(const BinBounds& other);
+            double area() const;
+        };
+
+        // Subtree handed to a worker; its nodes use local offsets until spliced in.
+        struct Subtree {
+            size_t start;
+            size_t end;
+            int depth;
+            std::vector<LinearBvhNode> nodes;
+        };
+
+        // Node of the serial top part of a parallel build. A node with subtree >= 0
+        // stands for that whole subtree.
+        struct TopNode {
+            BinBounds bounds;
+            uint8_t axis = 0;
+            int children[2] = {-1, -1};
+            int subtree = -1;
+        };
+
+        std::vector<LinearBvhNode> _nodes;
+        std::vector<uint32_t> _primitiveIndices;
+        BuildStats _stats;
+
+        int _buildTop(std::vector<BuildPrimitive>& primitives, size_t start, size_t end, int depth, size_t subtreeSize, std::vector<TopNode>& top, std::vector<Subtree>& subtrees);
+        void _emitTop(const std::vector<TopNode>& top, int index, std::vector<Subtree>& subtrees);
+        void _computeStats();
+
+        static uint32_t _buildSubtree(std::vector<BuildPrimitive>& primitives, size_t start, size_t end, int depth, std::vector<LinearBvhNode>& nodes);
+        static bool _split(std::vector<BuildPrimitive>& primitives, size_t start, size_t end, int depth, const BinBounds& bounds, const BinBounds& centroidBounds, size_t& mid, int& axis);
+        static void _computeBounds(const std::vector<BuildPrimitive>& primitives, size_t start, size_t end, BinBounds& bounds, BinBounds& centroidBounds);
+        static void _storeBounds(LinearBvhNode& node, const BinBounds& box);
+        static bool _hitNode(const LinearBvhNode& node, const point3& origin, const double invDir[3], const Interval& rayT);
+};
+
+inline bool LinearBvh::_hitNode(const LinearBvhNode& node, const point3& origin, const double invDir[3], const Interval& rayT)
+{
+    double tEnter = rayT.min;
+    double tExit = rayT.max;
+
+    for (int axis = 0; axis < 3; axis++) {
+        double t0 = (node.boundsMin[axis] - origin[axis]) * invDir[axis];
+        double t1 = (node.boundsMax[axis] - origin[axis]) * invDir[axis];
+
+        if (t0 > t1) std::swap(t0, t1);
+        if (t0 > tEnter) tEnter = t0;
+        if (t1 < tExit) tExit = t1;
+
+        if (tExit < tEnter) return false;
+    }
+
+    return true;
+}
+
+template <typename IntersectFn>
+bool LinearBvh::intersect(const Ray& r, Interval rayT, HitRecord& rec, IntersectFn&& intersectPrimitive) const
+{
+    if (this->_nodes.empty()) return false;
+
+    const point3& origin = r.origin();
+    const Vec3& direction = r.direction();
+    double invDir[3] = {1.0 / direction.x(), 1.0 / direction.y(), 1.0 / direction.z()};
+    bool dirIsNeg[3] = {invDir[0] < 0, invDir[1] < 0, invDir[2] < 0};
+
+    uint32_t stack[maxDepth];
+    int stackSize = 0;
+    uint32_t current = 0;
+    bool hitAnything = false;
+
+    while (true) {
+        const LinearBvhNode& node = this->_nodes[current];
+
+        if (_hitNode(node, origin, invDir, rayT)) {
+            if (!node.isLeaf()) {
+                // Descend into the child on the ray's side of the split first.
+                if (dirIsNeg[node.axis]) {
+                    stack[stackSize++] = current + 1;
+                    current = node.offset;
+                } else {
+                    stack[stackSize++] = node.offset;
+                    current = current + 1;
+                }
+                continue;
+            }
+
+            for (uint32_t i = 0; i < node.primitiveCount; i++) {
+                if (intersectPrimitive(this->_primitiveIndices[node.offset + i], rayT, rec)) {
+                    hitAnything = true;
+                    rayT.max = rec.t;
+                }
+            }
+        }
+
+        if (stackSize == 0) break;
+        current = stack[--stackSize];
+    }
+
+    return hitAnything;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Materials.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+enum class MaterialKind : uint8_t {
+    Lambertian,
+    Metal,
+    Dielectric,
+    DiffuseLight
+};
+
+// Resolved parameters of a raytracing material. parameter is the fuzz of a Metal and the
+// refraction index of a Dielectric.
+struct MaterialDesc {
+    MaterialKind kind = MaterialKind::Lambertian;
+    Color color = Color(0, 0, 0);
+    double parameter = 0.0;
+    std::shared_ptr<const CpuTexture> texture;
+
+    bool operator==(const MaterialDesc& other) const;
+};
+
+// Flyweight store of scene materials. Hits carry a 32-bit index into it instead of a
+// refcounted pointer; identical descriptions share one slot, which lives for as long as
+// something references it. Copies share the immutable material objects, so a copy is a
+// cheap snapshot for a background render.
+class MaterialTable {
+    public:
+        static constexpr uint32_t invalidIndex = 0xffffffffu;
+
+        uint32_t acquire(const MaterialDesc& desc);
+        void release(uint32_t index);
+        void clear();
+
+        // Returns fallback() for invalidIndex or a released slot.
+        const Materials& get(uint32_t index) const;
+        // Kind of the material get() returns for index.
+        MaterialKind kind(uint32_t index) const;
+        size_t size() const;
+
+        // Neutral grey Lambertian used when a hit has no material.
+        static const Materials& fallback();
+
+    private:
+        struct DescHash {
+            size_t operator()(const MaterialDesc& desc) const;
+        };
+
+        struct Slot {
+            std::shared_ptr<const Materials> material;
+            MaterialDesc desc;
+            uint32_t references = 0;
+        };
+
+        std::vector<Slot> _slots;
+        std::vector<uint32_t> _freeSlots;
+        std::unordered_map<MaterialDesc, uint32_t, DescHash> _lookup;
+
+        static std::shared_ptr<const Materials> _create(const MaterialDesc& desc);
+};
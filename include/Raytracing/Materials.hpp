@@ -3,12 +3,11 @@
 #include "Ray.hpp"
 #include "Hittable.hpp"
 #include "Interval.hpp"
-#include <ofMain.h>
+#include "TextureCache.hpp"
 
 #include <cmath>
 #include <cstdlib>
-
-class ofTexture;
+#include <memory>
 
 class Materials {
     public:
@@ -30,7 +29,7 @@ class Materials {
 
 class Lambertian : public Materials {
     public:
-        Lambertian(const Color& albedo, ofTexture* texture = nullptr);
+        Lambertian(const Color& albedo, std::shared_ptr<const CpuTexture> texture = nullptr);
 
         bool scatter(
             const Ray& rIn,
@@ -41,13 +40,12 @@ class Lambertian : public Materials {
 
     private:
         Color _albedo;
-        ofTexture* _texture;
-        ofPixels _cachedPixels;
+        std::shared_ptr<const CpuTexture> _texture;
 };
 
 class Metal : public Materials {
     public:
-        Metal(const Color& albedo, double fuzz, ofTexture* texture = nullptr);
+        Metal(const Color& albedo, double fuzz, std::shared_ptr<const CpuTexture> texture = nullptr);
 
         bool scatter(
             const Ray& rIn,
@@ -59,8 +57,7 @@ class Metal : public Materials {
     private:
         Color _albedo;
         double _fuzz;
-        ofTexture* _texture;
-        ofPixels _cachedPixels;
+        std::shared_ptr<const CpuTexture> _texture;
 };
 
 class Dielectric : public Materials {
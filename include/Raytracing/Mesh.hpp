@@ -1,27 +1,53 @@
 #pragma once
 
 #include "Hittable.hpp"
-#include "Triangles.hpp"
-#include "Bvh.hpp"
+#include "WideBvh.hpp"
 
+#include <cstdint>
 #include <vector>
 #include <memory>
 
-class Mesh : public Hittable {
+// Indexed triangle mesh. Vertices live once in a shared float buffer and triangles are
+// 32-bit index triples. buildBVH packs the intersection data (first vertex and both
+// edges) of each leaf into blocks of BVH-width lanes, so one ray is tested against 4 or 8
+// triangles at once. Optional per-vertex normals and UVs are interpolated at the hit point.
+class Mesh final : public Hittable {
     public:
-        Mesh(std::shared_ptr<Materials> mat);
+        Mesh(uint32_t material);
 
+        void reserve(size_t vertexCount, size_t triangleCount);
+        uint32_t addVertex(const point3& position);
+        void setVertexNormal(uint32_t vertex, const Vec3& normal);
+        void setVertexUV(uint32_t vertex, double u, double v);
+
+        void addTriangle(uint32_t i0, uint32_t i1, uint32_t i2);
         void addTriangle(const point3& v0, const point3& v1, const point3& v2);
-        void buildBVH();
+        void buildBVH(ThreadPool* threadPool = nullptr);
 
         bool hit(const Ray& r, Interval rayT, HitRecord& rec) const override;
+        bool occluded(const Ray& r, Interval rayT) const override;
         Aabb boundingBox() const override;
+        PrimitiveKind primitiveKind() const override;
         size_t triangleCount() const;
+        size_t vertexCount() const;
+        size_t memoryUsage() const;
+        size_t bvhNodeMemory() const;
+        const LinearBvh::BuildStats& bvhStats() const;
 
     private:
-        std::vector<std::shared_ptr<Triangles>> _triangles;
-        std::shared_ptr<Materials> _mat;
-        std::shared_ptr<Bvh> _bvhRoot;
+        std::vector<float> _positions;
+        std::vector<float> _normals;
+        std::vector<float> _uvs;
+        std::vector<uint32_t> _indices;
+        std::vector<float> _triangleBlocks;
+        std::vector<uint32_t> _blockTriangles;
+
+        uint32_t _material;
+        WideBvh _bvh;
         Aabb _bbox;
         bool _bvhBuilt;
+
+        point3 _position(uint32_t vertex) const;
+        void _packTriangles();
+        bool _hitLeaf(uint32_t firstSlot, uint32_t count, const SimdRay& ray, const Ray& r, const Interval& rayT, HitRecord& rec) const;
 };
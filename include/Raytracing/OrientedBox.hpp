@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Hittable.hpp"
+#include "Vec3.hpp"
+#include "Aabb.hpp"
+#include "AffineTransform.hpp"
+
+#include <cstdint>
+#include <glm/mat4x4.hpp>
+
+// Box primitive intersected analytically: the ray is moved into the box's frame and clipped
+// against the three slabs, so no triangle mesh or BVH is built for it.
+class OrientedBox final : public Hittable {
+    public:
+        OrientedBox(const glm::mat4& objectToWorld, const Vec3& halfExtents, uint32_t material);
+
+        bool hit(const Ray& r, Interval rayT, HitRecord& rec) const override;
+        bool occluded(const Ray& r, Interval rayT) const override;
+        Aabb boundingBox() const override;
+        PrimitiveKind primitiveKind() const override;
+
+    private:
+        AffineTransform _objectToWorld;
+        AffineTransform _worldToObject;
+        Vec3 _halfExtents;
+        uint32_t _material;
+        // Per face axis: the UV square stretched over that world-space face.
+        double _uvDensity[3];
+        Aabb _bbox;
+
+        // Entry and exit distances of r, already in object space. False on a miss.
+        bool _slabs(const Ray& r, double& tNear, double& tFar, int& nearAxis, int& farAxis) const;
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Hittable.hpp"
+
+// Non-owning handle to a hittable with its kind resolved up front. hit / occluded switch on
+// the kind and call the concrete class directly, so the closed primitive set costs a
+// predictable direct call inside traversal loops; Other falls back to virtual dispatch.
+struct PrimitiveRef {
+    const Hittable* object = nullptr;
+    PrimitiveKind kind = PrimitiveKind::Other;
+
+    PrimitiveRef() = default;
+    explicit PrimitiveRef(const Hittable* object);
+
+    bool hit(const Ray& r, Interval rayT, HitRecord& rec) const;
+    bool occluded(const Ray& r, Interval rayT) const;
+};
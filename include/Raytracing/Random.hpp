@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Sampler.hpp"
+
+#include <cstdint>
+
+// Per-thread PCG32 stream used by materials and Vec3 helpers. The camera reseeds it
+// for every pixel sample so results do not depend on which thread traced the pixel.
+class Random {
+    public:
+        static void seed(uint64_t seed);
+        static double uniform();
+        static double uniform(double min, double max);
+
+    private:
+        static thread_local Pcg32 _engine;
+};
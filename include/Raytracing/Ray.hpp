@@ -4,14 +4,31 @@
 
 class Ray {
     public:
-        Ray() = default;
-        Ray(const point3& origin, const Vec3& direction);
+        constexpr Ray() = default;
+        constexpr Ray(const point3& origin, const Vec3& direction);
 
-        const point3& origin() const;
-        const Vec3& direction() const;
-        point3 at(double t) const;
+        constexpr const point3& origin() const;
+        constexpr const Vec3& direction() const;
+        constexpr point3 at(double t) const;
 
     private:
         point3 _orig;
         Vec3 _dir;
 };
+
+constexpr Ray::Ray(const point3& origin, const Vec3& direction) : _orig(origin), _dir(direction) {}
+
+constexpr const point3& Ray::origin() const
+{
+    return this->_orig;
+}
+
+constexpr const Vec3& Ray::direction() const
+{
+    return this->_dir;
+}
+
+constexpr point3 Ray::at(double t) const
+{
+    return this->_orig + t * this->_dir;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "CameraWithLights.hpp"
+#include "Denoiser.hpp"
+#include "Lights.hpp"
+#include "RaytracingScene.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Progressive raytrace running on a background thread. start() copies everything the
+// trace reads (camera, lights, a scene snapshot), so the editor keeps mutating the live
+// scene meanwhile. Each finished tile is resolved and handed back for upload.
+class RaytracingJob {
+    public:
+        // Resolved RGB bytes of one tile, bottom row first; x and y are in the flipped
+        // image layout, ready for a sub-image texture upload.
+        struct TileUpdate {
+            int x = 0;
+            int y = 0;
+            int width = 0;
+            int height = 0;
+            std::vector<unsigned char> pixels;
+        };
+
+        RaytracingJob() = default;
+        ~RaytracingJob();
+
+        RaytracingJob(const RaytracingJob&) = delete;
+        RaytracingJob& operator=(const RaytracingJob&) = delete;
+
+        // Cancels any running trace and starts a new one from zero samples. It stops by
+        // itself once maxSamples samples per pixel have been accumulated, or, with the
+        // camera's adaptiveSampling, once every pixel has converged. With a denoiser, tiles
+        // are no longer published as they finish: each completed pass is denoised as a
+        // whole and then published.
+        void start(const CameraWithLights& camera, const sceneLights& lights, const RaytracingScene::Snapshot& scene, int maxSamples, const Denoiser* denoiser = nullptr);
+        // Requests cancellation and waits for the worker, which stops within one tile row.
+        void cancel();
+
+        bool running() const;
+        // Samples per pixel so far; in adaptive mode, the count of the pixels still sampled.
+        int sampleCount() const;
+        // Share of pixels the last pass skipped as converged; 0 without adaptive sampling.
+        double convergedFraction() const;
+
+        // Throughput of the current or last trace, 0 until something was measured.
+        double raysPerSecond() const;
+        // Average path length: rays traced per camera sample, shadow rays excluded.
+        double raysPerPath() const;
+
+        // Moves the tiles finished since the last call into updates. A tile finished
+        // several times in between is only reported once, with its latest pixels.
+        void takeTileUpdates(std::vector<TileUpdate>& updates);
+
+    private:
+        CameraWithLights _camera;
+        sceneLights _lights;
+        RaytracingScene::Snapshot _scene;
+        int _maxSamples = 0;
+
+        std::vector<CameraWithLights::Tile> _tiles;
+        std::vector<float> _accumulation;
+        CameraWithLights::PixelStats _stats;
+        bool _denoise = false;
+        Denoiser _denoiser;
+        CameraWithLights::AovBuffers _aovs;
+        Denoiser::Frame _frame;
+        std::vector<float> _denoised;
+
+        std::thread _thread;
+        std::atomic<bool> _cancelled{false};
+        std::atomic<bool> _running{false};
+        std::atomic<int> _sampleCount{0};
+        std::atomic<uint64_t> _rayCount{0};
+        std::atomic<uint64_t> _pathCount{0};
+        std::atomic<int64_t> _activeNanoseconds{0};
+        std::atomic<size_t> _activePixels{0};
+        std::chrono::steady_clock::time_point _startTime;
+
+        std::mutex _updateMutex;
+        std::vector<TileUpdate> _latestUpdates;
+        std::vector<uint8_t> _pending;
+        std::vector<uint32_t> _pendingTiles;
+
+        void _run();
+        void _denoisePass(int sampleCount);
+        void _publish(uint32_t tileIndex, std::vector<unsigned char>& pixels);
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+
+// Picks the internal resolution, samples per pass and bounce depth of the raytraced
+// viewport. While the view keeps changing it sizes each pass to fit a frame-time budget
+// from the measured ray throughput; once the view has been still for settleSeconds it
+// returns to full viewport resolution and depth and lets accumulation converge.
+class RaytracingQuality {
+    public:
+        struct Settings {
+            int width = 0;
+            int height = 0;
+            int samplesPerPixel = 1;
+            int maxDepth = 1;
+
+            bool operator==(const Settings& other) const;
+            bool operator!=(const Settings& other) const;
+        };
+
+        double targetFrameMilliseconds = 33.0;
+        double settleSeconds = 0.3;
+        double minScale = 0.125;
+        int maxWidth = 1920;
+
+        int interactiveDepth = 3;
+        int fullDepth = 8;
+        int fullSamplesPerPixel = 4;
+
+        // moving: the traced view changed since the previous frame. raysPerSecond and
+        // raysPerPath come from the trace that ran with the current settings.
+        Settings update(bool moving, int viewportWidth, int viewportHeight, double raysPerSecond, double raysPerPath);
+
+        bool settled() const;
+        double scale() const;
+        double raysPerSecond() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        Settings _settings;
+        int _viewportWidth = 0;
+        int _viewportHeight = 0;
+        double _scale = 0.25;
+        double _raysPerSecond = 0.0;
+        double _raysPerPath = 0.0;
+        bool _settled = false;
+        Clock::time_point _lastMotion = Clock::now();
+
+        static int _roundToTile(double value);
+};
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "Core/ComponentRegistry.hpp"
+#include "Core/EntityManager.hpp"
+#include "Components/Transform.hpp"
+#include "Components/Renderable.hpp"
+#include "Components/Primitive/Sphere.hpp"
+#include "Components/Primitive/Box.hpp"
+#include "Components/Primitive/Plane.hpp"
+#include "Components/DisplacementMap.hpp"
+
+#include "Hittable.hpp"
+#include "HittableList.hpp"
+#include "MaterialTable.hpp"
+#include "SphereSet.hpp"
+#include "OrientedBox.hpp"
+#include "FinitePlane.hpp"
+#include "Mesh.hpp"
+#include "Bvh.hpp"
+#include "Instance.hpp"
+
+#include <glm/mat4x4.hpp>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Raytracing mirror of the ECS scene. Each entity keeps its converted geometry and
+// material between frames; update() only rebuilds the records whose inputs changed.
+// Meshes are built once in object space, cached by content and placed with Instances,
+// so moving an entity or duplicating a mesh only touches the top-level BVH. Materials
+// live in a shared table and hits refer to them by index. Undisplaced box and plane
+// primitives skip the mesh entirely and are intersected analytically, and all spheres
+// are gathered into one SphereSet.
+// When no entity appears, disappears or changes kind, the top-level BVH and the sphere
+// set are refitted instead of rebuilt. Once refits have degraded either tree past
+// rebuildSahGrowth, a fresh one is built on a background thread and swapped in.
+class RaytracingScene {
+    public:
+        // BVH work done by the last update() that changed the scene; only rebuilt
+        // meshes are counted. A refitting update builds nothing at the top level.
+        struct Stats {
+            double bvhBuildMilliseconds = 0.0;
+            double refitMicroseconds = 0.0;
+            double topLevelSahCost = 0.0;
+            double sahGrowth = 1.0;
+            size_t bvhNodeCount = 0;
+            size_t bvhNodeBytes = 0;
+            size_t triangleCount = 0;
+            size_t sphereCount = 0;
+            size_t meshMemoryBytes = 0;
+            size_t cachedMeshCount = 0;
+            size_t materialCount = 0;
+            size_t textureMemoryBytes = 0;
+        };
+
+        // Immutable view of the traced world that stays valid while the live scene is
+        // updated, for renders running off the main thread.
+        struct Snapshot {
+            std::shared_ptr<const Hittable> world;
+            std::shared_ptr<const MaterialTable> materials;
+        };
+
+        RaytracingScene(ComponentRegistry& registry, EntityManager& entityManager);
+
+        // Returns true when the traced world differs from the previous update.
+        bool update();
+        void clear();
+        void setThreadPool(ThreadPool* threadPool);
+
+        const Hittable& world() const;
+        const MaterialTable& materials() const;
+        Snapshot snapshot();
+        bool empty() const;
+        size_t recordCount() const;
+        uint64_t generation() const;
+        const Stats& stats() const;
+
+        static void hashBytes(uint64_t& hash, const void* data, size_t size);
+
+        // SAH cost growth, relative to the built tree, past which refitted trees are rebuilt.
+        static constexpr double rebuildSahGrowth = 1.3;
+
+    private:
+        static constexpr uint32_t invalidSlot = 0xffffffffu;
+
+        struct Record {
+            glm::mat4 matrix{1.0f};
+            uint64_t materialKey = 0;
+            uint64_t geometryKey = 0;
+            // Renderable::meshRevision the geometry key was computed for.
+            uint64_t meshRevision = 0;
+            uint32_t material = MaterialTable::invalidIndex;
+            std::shared_ptr<Mesh> mesh;
+            std::shared_ptr<Hittable> geometry;
+            point3 sphereCenter;
+            double sphereRadius = 0.0;
+            // Index in the top-level BVH, or in the sphere set for spheres.
+            uint32_t slot = invalidSlot;
+            bool isSphere = false;
+            bool valid = false;
+            bool alive = false;
+        };
+
+        ComponentRegistry& _registry;
+        EntityManager& _entityManager;
+
+        std::unordered_map<EntityID, Record> _records;
+        std::unordered_map<uint64_t, std::shared_ptr<Mesh>> _meshCache;
+        MaterialTable _materials;
+        std::shared_ptr<const MaterialTable> _materialSnapshot;
+        std::shared_ptr<Bvh> _bvh;
+        std::shared_ptr<SphereSet> _sphereSet;
+        uint32_t _sphereObject = invalidSlot;
+        // Set when a snapshot may still reach the sphere set, which must then be copied
+        // before it is refitted.
+        bool _sphereSetShared = false;
+        uint64_t _generation = 0;
+        ThreadPool* _threadPool = nullptr;
+        Stats _stats;
+        Stats _pendingStats;
+
+        // Result of a background rebuild: the top-level tree over the object bounds, and a
+        // reclustered sphere set when that one had degraded too.
+        struct Rebuild {
+            WideBvh tree;
+            std::shared_ptr<SphereSet> spheres;
+        };
+
+        std::future<Rebuild> _rebuild;
+        // Records refitted while the rebuild runs, reapplied to its result. Records stay put
+        // until a restructure, which drops the rebuild first.
+        std::vector<const Record*> _movedDuringRebuild;
+
+        bool _updateRecord(EntityID id, Record& record, const Transform& transform, const Renderable& render);
+        void _rebuildTopLevel();
+        bool _refitTopLevel(const std::vector<const Record*>& moved);
+        void _addTopLevelStats();
+
+        void _startRebuild();
+        void _finishRebuild();
+        void _cancelRebuild();
+
+        static MaterialDesc _describeMaterial(const Renderable& render);
+        std::shared_ptr<Mesh> _acquireMesh(uint64_t geometryKey, const ofMesh& mesh);
+        std::shared_ptr<Mesh> _convertMesh(const ofMesh& mesh);
+
+        static uint64_t _materialKey(const Renderable& render);
+        static uint64_t _geometryKey(const Renderable& render, const Sphere* sphere, const Box* box, const Plane* plane);
+};
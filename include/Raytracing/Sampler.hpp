@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+// PCG32 (O'Neill): 64-bit state, 32-bit output, cheap enough to keep one per worker.
+struct Pcg32 {
+    uint64_t state = 0x853c49e6748fea9bULL;
+    uint64_t inc = 0xda3e39cb94b95bdbULL;
+
+    void seed(uint64_t initState, uint64_t sequence = 1)
+    {
+        this->state = 0;
+        this->inc = (sequence << 1u) | 1u;
+        this->nextUInt();
+        this->state += initState;
+        this->nextUInt();
+    }
+
+    uint32_t nextUInt()
+    {
+        uint64_t old = this->state;
+        this->state = old * 6364136223846793005ULL + this->inc;
+        uint32_t xorShifted = static_cast<uint32_t>(((old >> 18u) ^ old) >> 27u);
+        uint32_t rot = static_cast<uint32_t>(old >> 59u);
+        return (xorShifted >> rot) | (xorShifted << ((~rot + 1u) & 31));
+    }
+
+    double nextDouble()
+    {
+        return this->nextUInt() * (1.0 / 4294967296.0);
+    }
+};
+
+enum class SamplerType {
+    Independent,
+    Stratified,
+    Sobol
+};
+
+// Produces the sample values consumed by the camera for a given (pixel, sample index).
+// Dimensions are requested in order after startPixelSample; dimensions the sequence
+// does not cover fall back to a PCG stream keyed by the same pixel and sample.
+class Sampler {
+    public:
+        Sampler(uint64_t seed);
+        virtual ~Sampler() = default;
+
+        virtual void startPixelSample(int x, int y, int sampleIndex);
+        virtual double get1D();
+        virtual void get2D(double& u, double& v);
+
+        static std::unique_ptr<Sampler> create(SamplerType type, int samplesPerPixel, uint64_t seed);
+        static uint64_t hashPixelSample(uint64_t seed, int x, int y, int sampleIndex);
+
+    protected:
+        uint64_t _seed;
+        Pcg32 _rng;
+        int _x = 0;
+        int _y = 0;
+        int _sampleIndex = 0;
+        int _dimension = 0;
+};
+
+class IndependentSampler : public Sampler {
+    public:
+        IndependentSampler(uint64_t seed);
+};
+
+class StratifiedSampler : public Sampler {
+    public:
+        StratifiedSampler(int samplesPerPixel, uint64_t seed);
+
+        void get2D(double& u, double& v) override;
+
+    private:
+        int _strataPerAxis;
+};
+
+class SobolSampler : public Sampler {
+    public:
+        SobolSampler(uint64_t seed);
+
+        void startPixelSample(int x, int y, int sampleIndex) override;
+        double get1D() override;
+        void get2D(double& u, double& v) override;
+
+    private:
+        uint32_t _pixelHash = 0;
+
+        static uint32_t _sobol(uint32_t index, int dimension);
+        static uint32_t _reverseBits(uint32_t x);
+        static uint32_t _nestedUniformScramble(uint32_t x, uint32_t seed);
+        static uint32_t _hash(uint32_t x);
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Ray.hpp"
+#include "Interval.hpp"
+
+#include <cstdint>
+
+enum class SimdLevel {
+    Scalar,
+    SSE42,
+    AVX2
+};
+
+// Single-precision copy of a ray, prepared once per traversal for the wide kernels.
+struct SimdRay {
+    float origin[3];
+    float direction[3];
+    float invDirection[3];
+    float tMin;
+
+    SimdRay(const Ray& r, const Interval& rayT);
+};
+
+// Runtime-dispatched kernels testing one ray against 4 or 8 boxes / triangles / spheres stored in
+// structure-of-arrays form. The SSE4.2 and AVX2 variants are compiled with per-function
+// target attributes, so the rest of the project keeps its baseline compiler flags.
+namespace Simd {
+    SimdLevel detectedLevel();
+    SimdLevel activeLevel();
+    void setMaxLevel(SimdLevel level);
+    int preferredWidth();
+    const char* levelName(SimdLevel level);
+
+    // bounds holds minX, minY, minZ, maxX, maxY, maxZ rows of width lanes. Returns the
+    // mask of lanes hit within [ray.tMin, tMax] and writes their entry distances.
+    int intersectBoxes(int width, const float* bounds, const SimdRay& ray, float tMax, float* tNear);
+
+    // Same test on 8-bit boxes: each bound is origin[axis] + q * scale[axis], with q read from
+    // minX, minY, minZ, maxX, maxY, maxZ rows of width bytes.
+    int intersectQuantizedBoxes(int width, const uint8_t* bounds, const float origin[3], const float scale[3], const SimdRay& ray, float tMax, float* tNear);
+
+    // triangles holds v0x, v0y, v0z, e1x, e1y, e1z, e2x, e2y, e2z rows of width lanes.
+    // Returns the lane of the closest hit inside (ray.tMin, tMax), or -1.
+    int intersectTriangles(int width, const float* triangles, const SimdRay& ray, float tMax, float& t, float& u, float& v);
+
+    // spheres holds centerX, centerY, centerZ, radius rows of width lanes. Returns the lane of
+    // the closest hit inside (ray.tMin, tMax), or -1. Lanes with a NaN center never hit.
+    int intersectSpheres(int width, const float* spheres, const SimdRay& ray, float tMax, float& t);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Hittable.hpp"
+#include "WideBvh.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// Batch of spheres sharing one BVH. Spheres are grouped into spatially tight clusters of
+// up to one SIMD width; each cluster is a structure-of-arrays block of centers, radii and
+// material indices, and the BVH is built over cluster bounds. A leaf is thus
+// tested 4 or 8 spheres at a time instead of through one Hittable per sphere. The closest
+// candidate is re-solved in double precision, giving the same hits as Spheres. Spheres
+// keep the index they were added with, through which a built set can move them.
+class SphereSet final : public Hittable {
+    public:
+        void reserve(size_t sphereCount);
+        void add(const point3& center, double radius, uint32_t material);
+        void build(ThreadPool* threadPool = nullptr);
+
+        // Changes a sphere of a built set; the BVH only follows after refit().
+        void setSphere(uint32_t index, const point3& center, double radius, uint32_t material);
+        void refit(const std::vector<uint32_t>& changedSpheres);
+        double sahGrowth() const;
+
+        bool hit(const Ray& r, Interval rayT, HitRecord& rec) const override;
+        bool occluded(const Ray& r, Interval rayT) const override;
+        Aabb boundingBox() const override;
+        PrimitiveKind primitiveKind() const override;
+        size_t sphereCount() const;
+        size_t memoryUsage() const;
+        size_t bvhNodeMemory() const;
+        const LinearBvh::BuildStats& bvhStats() const;
+
+    private:
+        // Input spheres as x, y, z, radius; released once packed.
+        std::vector<float> _spheres;
+        std::vector<uint32_t> _materials;
+
+        std::vector<float> _clusterBlocks;
+        std::vector<uint32_t> _clusterMaterials;
+        // Lane of each input sphere in the cluster blocks, as cluster * width + lane.
+        std::vector<uint32_t> _sphereLanes;
+        int _clusterWidth = 4;
+        size_t _count = 0;
+
+        WideBvh _bvh;
+        Aabb _bbox;
+        bool _bvhBuilt = false;
+
+        Aabb _clusterBounds(uint32_t cluster) const;
+        void _cluster(int width, ThreadPool* threadPool, std::vector<uint32_t>& order, std::vector<uint32_t>& clusterStarts) const;
+        bool _hitLeaf(uint32_t firstSlot, uint32_t count, const SimdRay& ray, const Ray& r, const Interval& rayT, HitRecord& rec) const;
+};
@@ -4,21 +4,23 @@
 #include "Vec3.hpp"
 #include "Aabb.hpp"
 
-#include <memory>
+#include <cstdint>
 #include <algorithm>
 #include <cmath>
 
 
-class Spheres : public Hittable {
+class Spheres final : public Hittable {
     public:
-        Spheres(const point3& center, double radius, std::shared_ptr<Materials> mat);
+        Spheres(const point3& center, double radius, uint32_t material);
 
         bool hit(const Ray& r, Interval rayT, HitRecord& rec) const override;
+        bool occluded(const Ray& r, Interval rayT) const override;
         Aabb boundingBox() const override;
+        PrimitiveKind primitiveKind() const override;
 
     private:
         point3 _center;
         double _radius;
         Aabb _bbox;
-        std::shared_ptr<Materials> _mat;
+        uint32_t _material;
 };
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Vec3.hpp"
+#include <ofMain.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// CPU copy of a texture as an RGBA8 mip chain. Texel centres follow the raytracer's
+// convention: u = 0 and u = 1 map to the first and last column.
+class CpuTexture {
+    public:
+        struct Level {
+            int width = 0;
+            int height = 0;
+            std::vector<uint8_t> texels;
+        };
+
+        explicit CpuTexture(const ofPixels& pixels);
+
+        bool empty() const;
+        int levelCount() const;
+        size_t memoryUsage() const;
+
+        Color sampleBilinear(double u, double v, int level = 0) const;
+        // lod 0 is the full-resolution level; fractional values blend two levels.
+        Color sampleTrilinear(double u, double v, double lod) const;
+        // footprint is the width of the sampled area in UV units; the level whose texels are
+        // about that wide is used. 0 samples the full-resolution level.
+        Color sampleFootprint(double u, double v, double footprint) const;
+
+    private:
+        std::vector<Level> _levels;
+
+        void _buildMipChain();
+        Color _texel(const Level& level, int x, int y) const;
+};
+
+// Process-wide cache of CPU textures keyed by texture identity, so every material using
+// a texture shares one copy and the GPU readback only happens when the texture changes.
+class TextureCache {
+    public:
+        static TextureCache& instance();
+
+        // Returns the cached copy, reading the texture back if it is new or was replaced
+        // since the last call. Returns nullptr for a missing or unallocated texture.
+        std::shared_ptr<const CpuTexture> acquire(const ofTexture* texture);
+
+        // Drops entries no material holds any more.
+        void purgeUnused();
+        void clear();
+
+        // Incremented on every readback.
+        uint64_t generation() const;
+        size_t memoryUsage() const;
+
+        // Cheap fingerprint of the GL texture behind texture: changes when it is
+        // reallocated or replaced in place.
+        static uint64_t identity(const ofTexture* texture);
+
+    private:
+        struct Entry {
+            uint64_t identity = 0;
+            std::shared_ptr<const CpuTexture> texture;
+        };
+
+        TextureCache() = default;
+
+        mutable std::mutex _mutex;
+        std::unordered_map<const ofTexture*, Entry> _entries;
+        uint64_t _generation = 0;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+    public:
+        using Task = std::function<void(size_t index, size_t workerId)>;
+
+        explicit ThreadPool(size_t threadCount = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        void resize(size_t threadCount);
+        size_t size() const;
+
+        // Runs task(index, workerId) for every index in [0, count) and blocks until all are done.
+        // Each worker owns a contiguous block of indices and steals from the back of other
+        // workers' queues once its own runs dry. Must not be called from inside a task.
+        void parallelFor(size_t count, const Task& task);
+
+        static size_t defaultThreadCount();
+
+    private:
+        struct WorkQueue {
+            std::mutex mutex;
+            std::deque<size_t> items;
+        };
+
+        std::vector<std::thread> _workers;
+        std::vector<std::unique_ptr<WorkQueue>> _queues;
+
+        std::mutex _jobMutex;
+        std::mutex _stateMutex;
+        std::condition_variable _wakeCondition;
+        std::condition_variable _doneCondition;
+
+        const Task* _task = nullptr;
+        size_t _generation = 0;
+        size_t _pendingWorkers = 0;
+        bool _stopping = false;
+
+        void _start(size_t threadCount);
+        void _stop();
+        void _workerLoop(size_t workerId, size_t seenGeneration);
+        bool _nextItem(size_t workerId, size_t& index);
+};
@@ -4,25 +4,27 @@
 #include <iostream>
 #include <cstdlib>
 
+// The arithmetic is defined inline below so it folds into the intersection and shading
+// loops; only the random helpers live in Vec3.cpp.
 class Vec3 {
     public:
-        Vec3();
-        Vec3(double e0, double e1, double e2);
+        constexpr Vec3();
+        constexpr Vec3(double e0, double e1, double e2);
 
-        double x() const;
-        double y() const;
-        double z() const;
+        constexpr double x() const;
+        constexpr double y() const;
+        constexpr double z() const;
 
-        Vec3 operator-() const;
-        double operator[](int i) const;
-        double& operator[](int i);
+        constexpr Vec3 operator-() const;
+        constexpr double operator[](int i) const;
+        constexpr double& operator[](int i);
 
-        Vec3& operator+=(const Vec3& v);
-        Vec3& operator*=(double t);
-        Vec3& operator/=(double t);
+        constexpr Vec3& operator+=(const Vec3& v);
+        constexpr Vec3& operator*=(double t);
+        constexpr Vec3& operator/=(double t);
 
         double length() const;
-        double lengthSquared() const;
+        constexpr double lengthSquared() const;
         bool nearZero() const;
 
         static Vec3 random();
@@ -39,18 +41,138 @@ using point3 = Vec3;
 using Color = Vec3;
 
 std::ostream& operator<<(std::ostream& out, const Vec3& v);
-Vec3 operator+(const Vec3& u, const Vec3& v);
-Vec3 operator-(const Vec3& u, const Vec3& v);
-Vec3 operator*(const Vec3& u, const Vec3& v);
-Vec3 operator*(double t, const Vec3& v);
-Vec3 operator*(const Vec3& v, double t);
-Vec3 operator/(const Vec3& v, double t);
-
-double dot(const Vec3& u, const Vec3& v);
-Vec3 cross(const Vec3& u, const Vec3& v);
+constexpr Vec3 operator+(const Vec3& u, const Vec3& v);
+constexpr Vec3 operator-(const Vec3& u, const Vec3& v);
+constexpr Vec3 operator*(const Vec3& u, const Vec3& v);
+constexpr Vec3 operator*(double t, const Vec3& v);
+constexpr Vec3 operator*(const Vec3& v, double t);
+constexpr Vec3 operator/(const Vec3& v, double t);
+
+constexpr double dot(const Vec3& u, const Vec3& v);
+constexpr Vec3 cross(const Vec3& u, const Vec3& v);
 Vec3 unitVector(const Vec3& v);
 Vec3 randomInUnitSphere();
 Vec3 randomUnitVector();
 Vec3 randomOnHemisphere(const Vec3& normal);
-Vec3 reflect(const Vec3& v, const Vec3& n);
+constexpr Vec3 reflect(const Vec3& v, const Vec3& n);
 Vec3 refract(const Vec3& uv, const Vec3& n, double etaiOverEtat);
+
+constexpr Vec3::Vec3() : _e{0, 0, 0} {}
+constexpr Vec3::Vec3(double e0, double e1, double e2) : _e{e0, e1, e2} {}
+
+constexpr double Vec3::x() const
+{
+    return this->_e[0];
+}
+
+constexpr double Vec3::y() const
+{
+    return this->_e[1];
+}
+
+constexpr double Vec3::z() const
+{
+    return this->_e[2];
+}
+
+constexpr Vec3 Vec3::operator-() const
+{
+    return Vec3(-this->_e[0], -this->_e[1], -this->_e[2]);
+}
+
+constexpr double Vec3::operator[](int i) const
+{
+    return this->_e[i];
+}
+
+constexpr double& Vec3::operator[](int i)
+{
+    return this->_e[i];
+}
+
+constexpr Vec3& Vec3::operator+=(const Vec3& v)
+{
+    this->_e[0] += v._e[0];
+    this->_e[1] += v._e[1];
+    this->_e[2] += v._e[2];
+    return *this;
+}
+
+constexpr Vec3& Vec3::operator*=(double t)
+{
+    this->_e[0] *= t;
+    this->_e[1] *= t;
+    this->_e[2] *= t;
+    return *this;
+}
+
+constexpr Vec3& Vec3::operator/=(double t)
+{
+    return *this *= 1/t;
+}
+
+inline double Vec3::length() const
+{
+    return std::sqrt(this->lengthSquared());
+}
+
+constexpr double Vec3::lengthSquared() const
+{
+    return this->_e[0]*this->_e[0] + this->_e[1]*this->_e[1] + this->_e[2]*this->_e[2];
+}
+
+inline bool Vec3::nearZero() const
+{
+    auto s = 1e-8;
+    return (std::fabs(this->_e[0]) < s) && (std::fabs(this->_e[1]) < s) && (std::fabs(this->_e[2]) < s);
+}
+
+constexpr Vec3 operator+(const Vec3& u, const Vec3& v)
+{
+    return Vec3(u[0]+v[0], u[1]+v[1], u[2]+v[2]);
+}
+
+constexpr Vec3 operator-(const Vec3& u, const Vec3& v)
+{
+    return Vec3(u[0]-v[0], u[1]-v[1], u[2]-v[2]);
+}
+
+constexpr Vec3 operator*(const Vec3& u, const Vec3& v)
+{
+    return Vec3(u[0]*v[0], u[1]*v[1], u[2]*v[2]);
+}
+
+constexpr Vec3 operator*(double t, const Vec3& v)
+{
+    return Vec3(t*v[0], t*v[1], t*v[2]);
+}
+
+constexpr Vec3 operator*(const Vec3& v, double t)
+{
+    return t*v;
+}
+
+constexpr Vec3 operator/(const Vec3& v, double t)
+{
+    return (1/t)*v;
+}
+
+constexpr double dot(const Vec3& u, const Vec3& v)
+{
+    return u[0]*v[0] + u[1]*v[1] + u[2]*v[2];
+}
+
+constexpr Vec3 cross(const Vec3& u, const Vec3& v)
+{
+    return Vec3(u[1]*v[2]-u[2]*v[1], u[2]*v[0]-u[0]*v[2], u[0]*v[1]-u[1]*v[0]);
+}
+
+inline Vec3 unitVector(const Vec3& v)
+{
+    return v / v.length();
+}
+
+constexpr Vec3 reflect(const Vec3& v, const Vec3& n)
+{
+    return v - 2*dot(v,n)*n;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Aabb.hpp"
+#include "Hittable.hpp"
+#include "Lights.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class CameraWithLights;
+
+// Breadth-first path tracer. A batch of camera paths advances one bounce at a time through
+// separate extend (closest hit), shade (scatter and light selection) and shadow stages over
+// structure-of-arrays buffers. Before each extend, secondary rays are sorted by direction
+// octant and origin cell so consecutive traversals walk the same BVH nodes, and hits are
+// shaded grouped by material kind and index.
+class WavefrontTracer {
+    public:
+        void clear();
+        // Queues a camera path; the pixel and sample index seed its random numbers.
+        void addPath(int x, int y, int sample, const Ray& ray);
+        size_t pathCount() const;
+
+        // Follows every queued path with the camera's depth, roulette, lights and materials.
+        // Returns false when cancelled between bounces; results are then incomplete.
+        bool trace(const CameraWithLights& camera, const Hittable& world, uint64_t& rayCount, const std::atomic<bool>* cancelled = nullptr);
+
+        Color radiance(size_t path) const;
+        // First-hit guides, as CameraWithLights reports them for the denoiser.
+        Color albedo(size_t path) const;
+        Vec3 normal(size_t path) const;
+        double depth(size_t path) const;
+
+    private:
+        std::vector<int> _pixelX, _pixelY, _sample;
+        std::vector<double> _originX, _originY, _originZ;
+        std::vector<double> _directionX, _directionY, _directionZ;
+        std::vector<double> _throughputR, _throughputG, _throughputB;
+        std::vector<double> _radianceR, _radianceG, _radianceB;
+        std::vector<double> _albedoR, _albedoG, _albedoB;
+        std::vector<double> _normalX, _normalY, _normalZ;
+        std::vector<double> _depth;
+        // Width of the pixel's ray cone at the last hit, as in CameraWithLights::_rayColor.
+        std::vector<double> _coneWidth;
+
+        // Paths still alive at the current bounce, and the hits of the extend stage in the
+        // same order. _next collects the survivors of the shade stage.
+        std::vector<uint32_t> _active;
+        std::vector<uint32_t> _next;
+        std::vector<HitRecord> _hits;
+        std::vector<uint8_t> _hitFlags;
+        std::vector<uint64_t> _rayKeys;
+        std::vector<std::pair<uint64_t, uint32_t>> _shadeOrder;
+
+        std::vector<uint32_t> _shadowPath;
+        std::vector<double> _shadowOriginX, _shadowOriginY, _shadowOriginZ;
+        std::vector<double> _shadowDirectionX, _shadowDirectionY, _shadowDirectionZ;
+        std::vector<double> _shadowTMax;
+        std::vector<double> _shadowR, _shadowG, _shadowB;
+        std::vector<sceneLights::LightSample> _lightSamples;
+
+        void _sortRays(const Aabb& bounds);
+        void _extend(const CameraWithLights& camera, const Hittable& world, int bounce, uint64_t& rayCount);
+        void _shade(const CameraWithLights& camera, int bounce);
+        void _shadow(const Hittable& world);
+
+        Ray _ray(uint32_t path) const;
+        void _setRay(uint32_t path, const Ray& ray);
+        void _addRadiance(uint32_t path, const Color& color);
+        Color _throughput(uint32_t path) const;
+        void _setFirstHit(uint32_t path, const Color& albedo, const Vec3& normal, double depth);
+
+        static uint32_t _spreadBits(uint32_t value);
+};
@@ -0,0 +1,262 @@
+#pragma once
+
+#include "LinearBvh.hpp"
+#include "Simd.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+// Node of a 4- or 8-wide BVH. Child boxes are stored as minX, minY, minZ, maxX, maxY, maxZ
+// rows so one SIMD operation tests the ray against all of them. A child with count > 0 is
+// a leaf whose primitives start at slot child[i]; empty lanes have inverted bounds.
+template <int Width>
+struct alignas(32) WideBvhNode {
+    float bounds[6 * Width];
+    uint32_t child[Width];
+    uint8_t count[Width];
+
+    int intersect(const SimdRay& ray, float tMax, float* tNear) const
+    {
+        return Simd::intersectBoxes(Width, this->bounds, ray, tMax, tNear);
+    }
+};
+
+// Compressed node: child bounds are bytes on a grid spanning this node's own box, with a
+// power-of-two cell size per axis, rounded outwards so every child stays enclosed. The
+// 4-wide node fits one 64-byte cache line and the 8-wide one two, half the float layout.
+template <int Width>
+struct alignas(64) QuantizedWideBvhNode {
+    float origin[3];
+    int8_t exponent[3];
+    uint8_t validMask;
+    uint8_t bounds[6 * Width];
+    uint32_t child[Width];
+    uint8_t count[Width];
+
+    int intersect(const SimdRay& ray, float tMax, float* tNear) const
+    {
+        // 2^exponent, built straight from the float exponent bits.
+        float scale[3];
+        for (int axis = 0; axis < 3; axis++) {
+            uint32_t bits = static_cast<uint32_t>(this->exponent[axis] + 127) << 23;
+            std::memcpy(&scale[axis], &bits, sizeof(float));
+        }
+
+        return Simd::intersectQuantizedBoxes(Width, this->bounds, this->origin, scale, ray, tMax, tNear) & this->validMask;
+    }
+};
+
+static_assert(sizeof(QuantizedWideBvhNode<4>) == 64, "4-wide quantized node must fill one cache line");
+static_assert(sizeof(QuantizedWideBvhNode<8>) == 128, "8-wide quantized node must fill two cache lines");
+
+// Wide BVH collapsed from a binary SAH LinearBvh. The width follows the SIMD level at build
+// time: 8 with AVX2, 4 otherwise. Leaf slots are padded to a multiple of the width so
+// owners can store their primitives in matching SIMD blocks. With compressed nodes enabled
+// at build time, the float nodes are quantized once built and only the small ones are kept.
+// Moved primitives can be refitted in place; the topology stays the one built.
+class WideBvh {
+    public:
+        void build(const std::vector<Aabb>& primitiveBounds, ThreadPool* threadPool = nullptr);
+        void clear();
+
+        bool empty() const;
+        int width() const;
+        Aabb bounds() const;
+        size_t nodeCount() const;
+        size_t nodeMemory() const;
+        bool compressed() const;
+        const std::vector<uint32_t>& primitiveSlots() const;
+        const LinearBvh::BuildStats& buildStats() const;
+
+        // Recomputes the boxes of the leaves holding changedPrimitives and of their ancestors,
+        // bottom-up; primitiveBounds(index) returns a primitive's current bounds. Parent links
+        // are made on the first call, so trees that are never refitted do not pay for them.
+        void refit(const std::vector<uint32_t>& changedPrimitives, const std::function<Aabb(uint32_t)>& primitiveBounds);
+        // SAH cost of the wide tree over its cost before the first refit; 1 until refitted.
+        double sahGrowth() const;
+
+        // intersectLeaf(firstSlot, primitiveCount, simdRay, rayT, rec) returns true when it
+        // finds a hit inside rayT and fills rec. Children are visited nearest first.
+        template <typename LeafFn>
+        bool intersect(const Ray& r, Interval rayT, HitRecord& rec, LeafFn&& intersectLeaf) const;
+
+        // Any-hit traversal: stops at the first leaf for which occludedLeaf(firstSlot,
+        // primitiveCount, simdRay, rayT) returns true. Children are not sorted.
+        template <typename LeafFn>
+        bool occluded(const Ray& r, const Interval& rayT, LeafFn&& occludedLeaf) const;
+
+        static constexpr uint32_t invalidPrimitive = 0xffffffffu;
+
+        // Layout used by later builds; existing trees keep the one they were built with.
+        static void setCompressedNodes(bool compressed);
+        static bool compressedNodes();
+
+    private:
+        struct StackEntry {
+            uint32_t child;
+            uint32_t count;
+            float tNear;
+        };
+
+        int _width = 4;
+        bool _compressed = false;
+        std::vector<WideBvhNode<4>> _nodes4;
+        std::vector<WideBvhNode<8>> _nodes8;
+        std::vector<QuantizedWideBvhNode<4>> _quantized4;
+        std::vector<QuantizedWideBvhNode<8>> _quantized8;
+        std::vector<uint32_t> _slots;
+        size_t _primitiveCount = 0;
+        LinearBvh::BuildStats _stats;
+
+        // Refit state: parent of each node, leaf node of each primitive, and the sum of lane
+        // areas weighted by their SAH cost.
+        std::vector<uint32_t> _parents;
+        std::vector<uint32_t> _primitiveLeaves;
+        double _laneCost = 0.0;
+        double _builtSahCost = 0.0;
+
+        template <int Width>
+        uint32_t _collapse(const LinearBvh& binary, uint32_t binaryIndex, std::vector<WideBvhNode<Width>>& nodes);
+
+        template <int Width>
+        static void _quantize(const std::vector<WideBvhNode<Width>>& nodes, std::vector<QuantizedWideBvhNode<Width>>& quantized);
+
+        template <int Width, typename Node>
+        void _linkForRefit(const std::vector<Node>& nodes);
+
+        template <int Width, typename Node>
+        void _refit(std::vector<Node>& nodes, const std::vector<uint32_t>& changedPrimitives, const std::function<Aabb(uint32_t)>& primitiveBounds);
+
+        template <int Width>
+        static void _unpack(const WideBvhNode<Width>& node, WideBvhNode<Width>& unpacked);
+        template <int Width>
+        static void _unpack(const QuantizedWideBvhNode<Width>& node, WideBvhNode<Width>& unpacked);
+        template <int Width>
+        static void _pack(const WideBvhNode<Width>& node, WideBvhNode<Width>& packed);
+        template <int Width>
+        static void _pack(const WideBvhNode<Width>& node, QuantizedWideBvhNode<Width>& packed);
+
+        double _sahCost() const;
+
+        template <int Width, typename Node, typename LeafFn>
+        bool _intersect(const std::vector<Node>& nodes, const Ray& r, Interval rayT, HitRecord& rec, LeafFn& intersectLeaf) const;
+
+        template <int Width, typename Node, typename LeafFn>
+        bool _occluded(const std::vector<Node>& nodes, const Ray& r, const Interval& rayT, LeafFn& occludedLeaf) const;
+
+        static float _roundUp(double value);
+};
+
+template <typename LeafFn>
+bool WideBvh::intersect(const Ray& r, Interval rayT, HitRecord& rec, LeafFn&& intersectLeaf) const
+{
+    if (this->_compressed) {
+        if (this->_width == 8) return this->_intersect<8>(this->_quantized8, r, rayT, rec, intersectLeaf);
+        return this->_intersect<4>(this->_quantized4, r, rayT, rec, intersectLeaf);
+    }
+
+    if (this->_width == 8) return this->_intersect<8>(this->_nodes8, r, rayT, rec, intersectLeaf);
+    return this->_intersect<4>(this->_nodes4, r, rayT, rec, intersectLeaf);
+}
+
+template <int Width, typename Node, typename LeafFn>
+bool WideBvh::_intersect(const std::vector<Node>& nodes, const Ray& r, Interval rayT, HitRecord& rec, LeafFn& intersectLeaf) const
+{
+    if (nodes.empty()) return false;
+
+    SimdRay ray(r, rayT);
+    float tMax = _roundUp(rayT.max);
+    bool hitAnything = false;
+
+    StackEntry stack[LinearBvh::maxDepth * Width];
+    int stackSize = 0;
+    stack[stackSize++] = {0, 0, ray.tMin};
+
+    while (stackSize > 0) {
+        StackEntry entry = stack[--stackSize];
+
+        if (entry.tNear > tMax) continue;
+
+        if (entry.count > 0) {
+            if (intersectLeaf(entry.child, entry.count, ray, rayT, rec)) {
+                hitAnything = true;
+                rayT.max = rec.t;
+                tMax = _roundUp(rec.t);
+            }
+            continue;
+        }
+
+        const Node& node = nodes[entry.child];
+        alignas(32) float tNear[Width];
+        int mask = node.intersect(ray, tMax, tNear);
+
+        // Insertion-sort the hit children far to near so the nearest is popped first.
+        StackEntry hits[Width];
+        int hitCount = 0;
+
+        while (mask) {
+            int lane = __builtin_ctz(mask);
+            mask &= mask - 1;
+
+            StackEntry hitEntry = {node.child[lane], node.count[lane], tNear[lane]};
+            int position = hitCount++;
+            while (position > 0 && hits[position - 1].tNear < hitEntry.tNear) {
+                hits[position] = hits[position - 1];
+                position--;
+            }
+            hits[position] = hitEntry;
+        }
+
+        for (int i = 0; i < hitCount; i++)
+            stack[stackSize++] = hits[i];
+    }
+
+    return hitAnything;
+}
+
+template <typename LeafFn>
+bool WideBvh::occluded(const Ray& r, const Interval& rayT, LeafFn&& occludedLeaf) const
+{
+    if (this->_compressed) {
+        if (this->_width == 8) return this->_occluded<8>(this->_quantized8, r, rayT, occludedLeaf);
+        return this->_occluded<4>(this->_quantized4, r, rayT, occludedLeaf);
+    }
+
+    if (this->_width == 8) return this->_occluded<8>(this->_nodes8, r, rayT, occludedLeaf);
+    return this->_occluded<4>(this->_nodes4, r, rayT, occludedLeaf);
+}
+
+template <int Width, typename Node, typename LeafFn>
+bool WideBvh::_occluded(const std::vector<Node>& nodes, const Ray& r, const Interval& rayT, LeafFn& occludedLeaf) const
+{
+    if (nodes.empty()) return false;
+
+    SimdRay ray(r, rayT);
+    float tMax = _roundUp(rayT.max);
+
+    uint32_t stack[LinearBvh::maxDepth * Width];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const Node& node = nodes[stack[--stackSize]];
+        alignas(32) float tNear[Width];
+        int mask = node.intersect(ray, tMax, tNear);
+
+        while (mask) {
+            int lane = __builtin_ctz(mask);
+            mask &= mask - 1;
+
+            if (node.count[lane] == 0) {
+                stack[stackSize++] = node.child[lane];
+                continue;
+            }
+
+            if (occludedLeaf(node.child[lane], node.count[lane], ray, rayT)) return true;
+        }
+    }
+
+    return false;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
 #include <limits>
 #include <vector>
 #include <chrono>
@@ -28,9 +29,14 @@
 #include "Raytracing/Materials.hpp"
 #include "Raytracing/Bvh.hpp"
 #include "Raytracing/Lights.hpp"
-#include "Raytracing/Triangles.hpp"
 #include "Raytracing/Mesh.hpp"
 #include "Raytracing/SkyboxSampler.hpp"
+#include "Raytracing/ThreadPool.hpp"
+#include "Raytracing/RaytracingScene.hpp"
+#include "Raytracing/RaytracingJob.hpp"
+#include "Raytracing/Denoiser.hpp"
+#include "Raytracing/RaytracingQuality.hpp"
+#include "Raytracing/Simd.hpp"
 
 class SelectionSystem;
 
@@ -43,9 +49,53 @@ class RenderSystem {
         void loadCubemap(const std::string& folderPath);
         void setup(CameraManager& cameraManager, SelectionSystem& selectionSystem);
 
-        void enableRaytracing(bool enable) { _raytracingEnabled = enable; }
+        void enableRaytracing(bool enable);
         bool isRaytracingEnabled() const { return _raytracingEnabled; }
 
+        void setRaytracingThreadCount(size_t threadCount);
+        size_t getRaytracingThreadCount() const;
+
+        void setRaytracingSimdLevel(SimdLevel level);
+        SimdLevel getRaytracingSimdLevel() const { return Simd::activeLevel(); }
+        void setRaytracingCompressedBvh(bool compressed);
+        bool isRaytracingCompressedBvh() const { return WideBvh::compressedNodes(); }
+
+        void setRaytracingSampler(SamplerType type) { _raytracingCamera.samplerType = type; this->resetRaytracingAccumulation(); }
+        SamplerType getRaytracingSampler() const { return _raytracingCamera.samplerType; }
+
+        // Accumulation stops once every pixel has this many samples; the heat map is scaled to it.
+        void setRaytracingMaxSamples(int samples) { _raytracingMaxSamples = std::max(1, samples); this->resetRaytracingAccumulation(); }
+        int getRaytracingMaxSamples() const { return _raytracingMaxSamples; }
+        void setRaytracingAdaptiveSampling(bool enable) { _raytracingCamera.adaptiveSampling = enable; this->resetRaytracingAccumulation(); }
+        bool isRaytracingAdaptiveSampling() const { return _raytracingCamera.adaptiveSampling; }
+        void setRaytracingNoiseThreshold(double threshold) { _raytracingCamera.noiseThreshold = threshold; this->resetRaytracingAccumulation(); }
+        double getRaytracingNoiseThreshold() const { return _raytracingCamera.noiseThreshold; }
+        void setRaytracingSampleHeatMap(bool enable) { _raytracingCamera.sampleHeatMap = enable; this->resetRaytracingAccumulation(); }
+        bool isRaytracingSampleHeatMap() const { return _raytracingCamera.sampleHeatMap; }
+
+        void setRaytracingRussianRoulette(bool enable) { _raytracingCamera.russianRoulette = enable; this->resetRaytracingAccumulation(); }
+        bool isRaytracingRussianRoulette() const { return _raytracingCamera.russianRoulette; }
+        void setRaytracingRouletteMinDepth(int depth) { _raytracingCamera.rouletteMinDepth = depth; this->resetRaytracingAccumulation(); }
+        int getRaytracingRouletteMinDepth() const { return _raytracingCamera.rouletteMinDepth; }
+        double getRaytracingAveragePathLength() const { return _raytracingJob.raysPerPath(); }
+
+        void setRaytracingLightSampling(LightSampling sampling) { _sceneLights.sampling = sampling; this->resetRaytracingAccumulation(); }
+        LightSampling getRaytracingLightSampling() const { return _sceneLights.sampling; }
+
+        void setRaytracingDenoise(bool enable) { _raytracingDenoise = enable; this->resetRaytracingAccumulation(); }
+        bool isRaytracingDenoise() const { return _raytracingDenoise; }
+        double getRaytracingConvergedFraction() const { return _raytracingJob.convergedFraction(); }
+
+        const RaytracingScene::Stats& getRaytracingSceneStats() const { return _raytracingScene.stats(); }
+
+        void resetRaytracingAccumulation() { _raytracingRestartRequested = true; }
+        int getRaytracingSampleCount() const { return _raytracingJob.sampleCount(); }
+
+        void setRaytracingFrameBudget(double milliseconds) { _raytracingQuality.targetFrameMilliseconds = milliseconds; }
+        double getRaytracingFrameBudget() const { return _raytracingQuality.targetFrameMilliseconds; }
+        const RaytracingQuality::Settings& getRaytracingSettings() const { return _raytracingSettings; }
+        const RaytracingQuality& getRaytracingQuality() const { return _raytracingQuality; }
+
     private:
         ComponentRegistry& _registry;
         EntityManager& _entityManager;
@@ -61,7 +111,6 @@ class RenderSystem {
         void _collectLights(std::vector<LightSource>& lights);
         void _setLightUniforms(ofShader* shader, const std::vector<LightSource>& lights);
         void _drawLightDirectionIndicator(const LightSource& light, const glm::mat4& transform);
-        int _convertMeshToRaytracing(const ofMesh& ofMesh, const glm::mat4& transform, std::shared_ptr<Materials> mat, HittableList& world);
 
         ofShader _skyCubeShader;
         ofVboMesh _skyQuad;
@@ -78,12 +127,26 @@ class RenderSystem {
 
         bool _raytracingEnabled = false;
         CameraWithLights _raytracingCamera;
+        RaytracingScene _raytracingScene;
         sceneLights _sceneLights;
         SkyboxSampler _skyboxSampler;
-        std::vector<unsigned char> _raytracingPixels;
+        uint64_t _raytracingStateHash = 0;
+        bool _raytracingRestartRequested = true;
+        int _raytracingMaxSamples = 1024;
+        RaytracingQuality _raytracingQuality;
+        bool _raytracingDenoise = false;
+        Denoiser _raytracingDenoiser;
+        RaytracingQuality::Settings _raytracingSettings;
         ofTexture _raytracingTexture;
+        ofTexture _raytracingPreviousTexture;
+        std::vector<RaytracingJob::TileUpdate> _raytracingTileUpdates;
+        ThreadPool _raytracingThreadPool;
+        // Declared last so it is cancelled before anything it reads is destroyed.
+        RaytracingJob _raytracingJob;
 
         void _renderRaytracing();
-        void _buildRaytracingScene(HittableList& world);
+        void _uploadRaytracingTiles();
+        void _resizeRaytracingTexture(int width, int height);
         void _collectSceneLights();
+        uint64_t _hashRaytracingState() const;
 };
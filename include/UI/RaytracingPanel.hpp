@@ -0,0 +1,14 @@
+#pragma once
+
+#include "Systems/RenderSystem.hpp"
+#include "imgui.h"
+
+class RaytracingPanel {
+    public:
+        RaytracingPanel(RenderSystem& renderSystem);
+
+        void render();
+
+    private:
+        RenderSystem& _renderSystem;
+};
@@ -1,5 +1,7 @@
 #include "Components/Renderable.hpp"
 
+#include <atomic>
+
 Renderable::Renderable(
     const ofMesh& m,
     const ofColor& c,
@@ -17,11 +19,13 @@ Renderable::Renderable(
     material->shader = s;
     if (s) material->effects.push_back(s);
     material->texture = t;
+    markMeshChanged();
 }
 
 Renderable::Renderable(const Renderable& other)
 :
     mesh(other.mesh),
+    meshRevision(other.meshRevision),
     color(other.color),
     visible(other.visible),
     showOutline(other.showOutline),
@@ -35,6 +39,7 @@ Renderable& Renderable::operator=(const Renderable& other)
 {
     if (this != &other) {
         mesh = other.mesh;
+        meshRevision = other.meshRevision;
         color = other.color;
         visible = other.visible;
         showOutline = other.showOutline;
@@ -51,3 +56,9 @@ Renderable::~Renderable()
 {
     delete material;
 }
+
+void Renderable::markMeshChanged()
+{
+    static std::atomic<uint64_t> lastRevision{0};
+    meshRevision = ++lastRevision;
+}
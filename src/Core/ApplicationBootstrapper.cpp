@@ -159,6 +159,7 @@ bool ApplicationBootstrapper::_InitializeManagers()
 bool ApplicationBootstrapper::_InitializeUI()
 {
     this->_ui.skyboxPanel = std::make_unique<SkyboxPanel>(*this->_systems.renderSystem);
+    this->_ui.raytracingPanel = std::make_unique<RaytracingPanel>(*this->_systems.renderSystem);
     this->_ui.materialPanel = std::make_unique<MaterialPanel>(this->_componentRegistry, *this->_systems.selectionSystem, *this->_managers.resourceManager, *this->_systems.primitiveSystem);
     this->_ui.transformPanel = std::make_unique<TranformPanel>(this->_componentRegistry, *this->_systems.selectionSystem);
     this->_ui.colorPanel = std::make_unique<ColorPanel>(this->_componentRegistry, *this->_systems.selectionSystem, this->_eventManager);
@@ -253,6 +254,7 @@ bool ApplicationBootstrapper::_SetupCallbacks()
     this->_managers.uiManager->setupUI(
         *this->_ui.toolbar,
         *this->_ui.skyboxPanel,
+        *this->_ui.raytracingPanel,
         *this->_ui.instructionsPanel,
         *this->_ui.eventLogPanel,
         *this->_ui.exportPanel,
@@ -25,6 +25,7 @@ void UIManager::render()
     this->_instructionsPanel->render();
     this->_eventLogPanel->render();
     this->_skyboxPanel->render();
+    this->_raytracingPanel->render();
     this->_viewportPanel->render();
 
     if (this->_shouldFocusPrimitives) {
@@ -77,10 +78,11 @@ void UIManager::setupDockspace()
     ImGui::PopStyleVar(3);
 }
 
-void UIManager::setupUI(Toolbar& toolbar, SkyboxPanel& skyboxPanel, InstructionsPanel& instructionsPanel, EventLogPanel& eventLogPanel, ExportPanel& exportPanel, ImportPanel& importPanel, EntitiesPanel& entitiesPanel, CurvesPanel& curvesPanel, ViewportPanel& viewportPanel)
+void UIManager::setupUI(Toolbar& toolbar, SkyboxPanel& skyboxPanel, RaytracingPanel& raytracingPanel, InstructionsPanel& instructionsPanel, EventLogPanel& eventLogPanel, ExportPanel& exportPanel, ImportPanel& importPanel, EntitiesPanel& entitiesPanel, CurvesPanel& curvesPanel, ViewportPanel& viewportPanel)
 {
     this->_toolbar = &toolbar;
     this->_skyboxPanel = &skyboxPanel;
+    this->_raytracingPanel = &raytracingPanel;
     this->_instructionsPanel = &instructionsPanel;
     this->_eventLogPanel = &eventLogPanel;
     this->_exportPanel = &exportPanel;
@@ -113,6 +115,7 @@ void UIManager::_setupInitialLayout()
     ImGui::DockBuilderDockWindow("Event Log", dockDown);
     ImGui::DockBuilderDockWindow("Instructions", dockDown);
     ImGui::DockBuilderDockWindow("Skybox Settings", dockDown);
+    ImGui::DockBuilderDockWindow("Raytracing Settings", dockDown);
 
     ImGui::DockBuilderFinish(this->_dockspaceId);
 }
@@ -0,0 +1,37 @@
+#include "AffineTransform.hpp"
+
+AffineTransform::AffineTransform(const glm::mat4& matrix)
+{
+    for (int row = 0; row < 3; row++)
+        for (int col = 0; col < 4; col++)
+            this->m[row][col] = matrix[col][row];
+}
+
+double AffineTransform::determinant() const
+{
+    return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+         - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+         + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+}
+
+Aabb AffineTransform::bounds(const Aabb& box) const
+{
+    double lo[3] = {INFINITY, INFINITY, INFINITY};
+    double hi[3] = {-INFINITY, -INFINITY, -INFINITY};
+
+    for (int corner = 0; corner < 8; corner++) {
+        point3 p(
+            (corner & 1) ? box.x.max : box.x.min,
+            (corner & 2) ? box.y.max : box.y.min,
+            (corner & 4) ? box.z.max : box.z.min
+        );
+        point3 world = this->point(p);
+
+        for (int axis = 0; axis < 3; axis++) {
+            lo[axis] = std::fmin(lo[axis], world[axis]);
+            hi[axis] = std::fmax(hi[axis], world[axis]);
+        }
+    }
+
+    return Aabb(point3(lo[0], lo[1], lo[2]), point3(hi[0], hi[1], hi[2]));
+}
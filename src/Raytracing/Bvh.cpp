@@ -1,62 +1,42 @@
 #include "Bvh.hpp"
 
-Bvh::Bvh(const HittableList& list) :
-    Bvh(
-        const_cast<std::vector<std::shared_ptr<Hittable>>&>(list.objects),
-        0, list.objects.size()
-    )
-{}
-
-Bvh::Bvh(std::vector<std::shared_ptr<Hittable>>& objects, size_t start, size_t end)
+Bvh::Bvh(const HittableList& list, ThreadPool* threadPool) : _objects(list.objects)
 {
-    Aabb totalBox = this->_computeBoundingBox(objects, start, end);
-    int axis = totalBox.longestAxis();
-
-    auto comparator =
-        (axis == 0) ? this->_boxXCompare :
-        (axis == 1) ? this->_boxYCompare :
-                      this->_boxZCompare;
-
-    size_t objectSpan = end - start;
-
-    if (objectSpan == 1) {
-        this->_left = objects[start];
-        this->_right = objects[start];
-    } else if (objectSpan == 2) {
-        if (comparator(objects[start], objects[start + 1])) {
-            this->_left = objects[start];
-            this->_right = objects[start + 1];
-        } else {
-            this->_left = objects[start + 1];
-            this->_right = objects[start];
-        }
-    } else {
-        std::sort(objects.begin() + start, objects.begin() + end, comparator);
-
-        size_t mid = start + objectSpan / 2;
-
-        this->_left  = std::make_shared<Bvh>(objects, start, mid);
-        this->_right = std::make_shared<Bvh>(objects, mid, end);
-    }
+    std::vector<Aabb> bounds;
+    bounds.reserve(this->_objects.size());
 
-    Aabb leftBox  = this->_getBox(this->_left);
-    Aabb rightBox = this->_getBox(this->_right);
+    for (const auto& object : this->_objects)
+        bounds.push_back(object->boundingBox());
 
-    this->_bbox = Aabb::surroundingBox(leftBox, rightBox);
+    this->_tree.build(bounds, threadPool);
+    this->_bbox = list.boundingBox();
+    this->_linkSlots();
 }
 
 bool Bvh::hit(const Ray& r, Interval rayT, HitRecord& rec) const
 {
-    if (!this->_bbox.hit(r, rayT)) return false;
+    return this->_tree.intersect(r, rayT, rec, [this, &r](uint32_t firstSlot, uint32_t count, const SimdRay&, Interval t, HitRecord& record) {
+        bool hitAnything = false;
+
+        for (uint32_t slot = firstSlot; slot < firstSlot + count; slot++) {
+            if (this->_slotPrimitives[slot].hit(r, t, record)) {
+                hitAnything = true;
+                t.max = record.t;
+            }
+        }
 
-    bool hitLeft  = this->_left->hit(r, rayT, rec);
-    bool hitRight = this->_right->hit(
-        r,
-        Interval(rayT.min, hitLeft ? rec.t : rayT.max),
-        rec
-    );
+        return hitAnything;
+    });
+}
 
-    return hitLeft || hitRight;
+bool Bvh::occluded(const Ray& r, Interval rayT) const
+{
+    return this->_tree.occluded(r, rayT, [this, &r](uint32_t firstSlot, uint32_t count, const SimdRay&, const Interval& t) {
+        for (uint32_t slot = firstSlot; slot < firstSlot + count; slot++)
+            if (this->_slotPrimitives[slot].occluded(r, t)) return true;
+
+        return false;
+    });
 }
 
 Aabb Bvh::boundingBox() const
@@ -64,52 +44,65 @@ Aabb Bvh::boundingBox() const
     return this->_bbox;
 }
 
-Aabb Bvh::_computeBoundingBox(
-    const std::vector<std::shared_ptr<Hittable>>& objects,
-    size_t start,
-    size_t end
-) {
-    Aabb result = _getBox(objects[start]);
+size_t Bvh::nodeCount() const
+{
+    return this->_tree.nodeCount();
+}
 
-    for (size_t i = start + 1; i < end; i++)
-        result = Aabb::surroundingBox(result, _getBox(objects[i]));
+size_t Bvh::nodeMemory() const
+{
+    return this->_tree.nodeMemory();
+}
 
-    return result;
+const LinearBvh::BuildStats& Bvh::buildStats() const
+{
+    return this->_tree.buildStats();
 }
 
-bool Bvh::_boxCompare(
-    const std::shared_ptr<Hittable> a,
-    const std::shared_ptr<Hittable> b,
-    int axisIndex
-) {
-    Aabb boxA = _getBox(a);
-    Aabb boxB = _getBox(b);
+size_t Bvh::objectCount() const
+{
+    return this->_objects.size();
+}
+
+const std::shared_ptr<Hittable>& Bvh::object(uint32_t index) const
+{
+    return this->_objects[index];
+}
 
-    return boxA.axisInterval(axisIndex).min < boxB.axisInterval(axisIndex).min;
+void Bvh::setObject(uint32_t index, std::shared_ptr<Hittable> object)
+{
+    this->_objects[index] = std::move(object);
+    this->_slotPrimitives[this->_objectSlots[index]] = PrimitiveRef(this->_objects[index].get());
 }
 
-bool Bvh::_boxXCompare(
-    const std::shared_ptr<Hittable> a,
-    const std::shared_ptr<Hittable> b
-) {
-    return _boxCompare(a, b, 0);
+void Bvh::refit(const std::vector<uint32_t>& changedObjects)
+{
+    this->_tree.refit(changedObjects, [this](uint32_t index) { return this->_objects[index]->boundingBox(); });
+    this->_bbox = this->_tree.bounds();
 }
 
-bool Bvh::_boxYCompare(
-    const std::shared_ptr<Hittable> a,
-    const std::shared_ptr<Hittable> b
-) {
-    return _boxCompare(a, b, 1);
+double Bvh::sahGrowth() const
+{
+    return this->_tree.sahGrowth();
 }
 
-bool Bvh::_boxZCompare(
-    const std::shared_ptr<Hittable> a,
-    const std::shared_ptr<Hittable> b
-) {
-    return _boxCompare(a, b, 2);
+void Bvh::setTree(WideBvh&& tree)
+{
+    this->_tree = std::move(tree);
+    this->_bbox = this->_tree.bounds();
+    this->_linkSlots();
 }
 
-Aabb Bvh::_getBox(const std::shared_ptr<Hittable>& obj)
+void Bvh::_linkSlots()
 {
-    return obj->boundingBox();
+    const std::vector<uint32_t>& slots = this->_tree.primitiveSlots();
+    this->_slotPrimitives.assign(slots.size(), PrimitiveRef());
+    this->_objectSlots.assign(this->_objects.size(), WideBvh::invalidPrimitive);
+
+    for (size_t slot = 0; slot < slots.size(); slot++) {
+        if (slots[slot] == WideBvh::invalidPrimitive) continue;
+
+        this->_slotPrimitives[slot] = PrimitiveRef(this->_objects[slots[slot]].get());
+        this->_objectSlots[slots[slot]] = static_cast<uint32_t>(slot);
+    }
 }
@@ -1,45 +1,282 @@
 #include "CameraWithLights.hpp"
+#include "WavefrontTracer.hpp"
 
 void CameraWithLights::render(const Hittable& world, std::vector<unsigned char>& pixels)
+{
+    std::vector<float> accumulation;
+
+    this->accumulate(world, accumulation, 0);
+    this->resolve(accumulation, samplesPerPixel, pixels);
+}
+
+void CameraWithLights::accumulate(const Hittable& world, std::vector<float>& accumulation, int sampleOffset)
+{
+    std::vector<Tile> tiles = this->prepareTiles();
+
+    accumulation.resize(imageWidth * this->_imageHeight * 3, 0.0f);
+
+    if (this->threadPool) {
+        this->threadPool->parallelFor(tiles.size(), [&](size_t index, size_t) {
+            this->renderTile(tiles[index], world, accumulation, sampleOffset);
+        });
+    } else {
+        for (const Tile& tile : tiles)
+            this->renderTile(tile, world, accumulation, sampleOffset);
+    }
+}
+
+void CameraWithLights::resolve(const std::vector<float>& accumulation, int sampleCount, std::vector<unsigned char>& pixels) const
+{
+    pixels.resize(accumulation.size());
+
+    double scale = 1.0 / std::max(1, sampleCount);
+
+    for (size_t i = 0; i < accumulation.size(); i++)
+        pixels[i] = _toByte(accumulation[i], scale);
+}
+
+int CameraWithLights::imageHeight() const
+{
+    return std::max(1, int(imageWidth / aspectRatio));
+}
+
+std::vector<CameraWithLights::Tile> CameraWithLights::prepareTiles()
 {
     this->_initialize();
+    return this->_buildTiles();
+}
+
+void CameraWithLights::resolveTile(const Tile& tile, const std::vector<float>& accumulation, int sampleCount, std::vector<unsigned char>& pixels, const PixelStats* stats) const
+{
+    int width = tile.x1 - tile.x0;
+    double scale = 1.0 / std::max(1, sampleCount);
+
+    pixels.resize(static_cast<size_t>(width) * (tile.y1 - tile.y0) * 3);
+
+    size_t out = 0;
+    for (int row = this->_imageHeight - tile.y1; row < this->_imageHeight - tile.y0; row++) {
+        size_t first = static_cast<size_t>(row) * imageWidth + tile.x0;
+        const float* source = &accumulation[first * 3];
+
+        if (!stats) {
+            for (int i = 0; i < width * 3; i++)
+                pixels[out++] = _toByte(source[i], scale);
+            continue;
+        }
+
+        for (int i = 0; i < width; i++, out += 3) {
+            uint32_t count = stats->sampleCounts[first + i];
+
+            if (this->sampleHeatMap) {
+                _heatColor(count * scale, &pixels[out]);
+                continue;
+            }
+
+            double pixelScale = 1.0 / std::max<uint32_t>(1, count);
+            for (int c = 0; c < 3; c++)
+                pixels[out + c] = _toByte(source[i * 3 + c], pixelScale);
+        }
+    }
+}
+
+std::vector<CameraWithLights::Tile> CameraWithLights::_buildTiles() const
+{
+    int size = std::max(1, this->tileSize);
+    std::vector<Tile> tiles;
+
+    for (int y = 0; y < this->_imageHeight; y += size)
+        for (int x = 0; x < imageWidth; x += size)
+            tiles.push_back({x, y, std::min(x + size, imageWidth), std::min(y + size, this->_imageHeight)});
 
-    pixels.resize(imageWidth * this->_imageHeight * 3);
+    return tiles;
+}
+
+bool CameraWithLights::renderTile(const Tile& tile, const Hittable& world, std::vector<float>& accumulation, int sampleOffset, TileContext* context) const
+{
+    if (this->traceMode == TraceMode::Wavefront)
+        return this->_renderTileWavefront(tile, world, accumulation, sampleOffset, context);
+
+    std::unique_ptr<Sampler> sampler = Sampler::create(this->samplerType, samplesPerPixel, this->seed);
+    const std::atomic<bool>* cancelled = context ? context->cancelled : nullptr;
+    PixelStats* stats = context && this->adaptiveSampling ? context->stats : nullptr;
+    AovBuffers* aovs = context ? context->aovs : nullptr;
+    uint64_t rays = 0;
+    uint64_t pixelsSampled = 0;
+    bool finished = true;
+
+    for (int j = tile.y0; j < tile.y1; j++) {
+        if (cancelled && cancelled->load(std::memory_order_relaxed)) {
+            finished = false;
+            break;
+        }
+
+        for (int i = tile.x0; i < tile.x1; i++) {
+            size_t pixel = static_cast<size_t>(this->_imageHeight - 1 - j) * imageWidth + i;
+            int firstSample = sampleOffset;
+
+            if (stats) {
+                if (this->_converged(&accumulation[pixel * 3], stats->luminanceSquares[pixel], stats->sampleCounts[pixel])) continue;
+                firstSample = static_cast<int>(stats->sampleCounts[pixel]);
+            }
 
-    for (int j = 0; j < this->_imageHeight; j++) {
-        for (int i = 0; i < imageWidth; i++) {
             Color pixel_color(0, 0, 0);
+            double luminanceSquares = 0.0;
+            FirstHit hitSum;
+            FirstHit firstHit;
+
+            for (int sample = firstSample; sample < firstSample + samplesPerPixel; sample++) {
+                sampler->startPixelSample(i, j, sample);
+                Random::seed(Sampler::hashPixelSample(this->seed ^ 0x5bd1e995ULL, i, j, sample));
+
+                Ray r = this->_getRay(i, j, *sampler);
+                Color sampleColor = this->_rayColor(r, world, rays, aovs ? &firstHit : nullptr);
+                double luminance = _luminance(sampleColor);
+
+                pixel_color += sampleColor;
+                luminanceSquares += luminance * luminance;
+
+                if (aovs) {
+                    hitSum.albedo += firstHit.albedo;
+                    hitSum.normal += firstHit.normal;
+                    hitSum.depth += firstHit.depth;
+                }
+            }
 
-            for (int sample = 0; sample < samplesPerPixel; sample++) {
-                Ray r = this->_getRay(i, j);
-                pixel_color += this->_rayColor(r, maxDepth, world);
+            this->_accumulatePixel(pixel, pixel_color, luminanceSquares, hitSum, accumulation, stats, aovs);
+            pixelsSampled++;
+        }
+    }
+
+    if (context) {
+        context->rays += rays;
+        context->pixelsSampled += pixelsSampled;
+    }
+
+    return finished;
+}
+
+// Queues every sample of the tile's unconverged pixels, traces them as one batch and
+// then folds the results back per pixel. A per-thread tracer keeps its buffers warm.
+bool CameraWithLights::_renderTileWavefront(const Tile& tile, const Hittable& world, std::vector<float>& accumulation, int sampleOffset, TileContext* context) const
+{
+    thread_local WavefrontTracer tracer;
+
+    std::unique_ptr<Sampler> sampler = Sampler::create(this->samplerType, samplesPerPixel, this->seed);
+    const std::atomic<bool>* cancelled = context ? context->cancelled : nullptr;
+    PixelStats* stats = context && this->adaptiveSampling ? context->stats : nullptr;
+    AovBuffers* aovs = context ? context->aovs : nullptr;
+    std::vector<size_t> pixels;
+
+    tracer.clear();
+
+    for (int j = tile.y0; j < tile.y1; j++) {
+        for (int i = tile.x0; i < tile.x1; i++) {
+            size_t pixel = static_cast<size_t>(this->_imageHeight - 1 - j) * imageWidth + i;
+            int firstSample = sampleOffset;
+
+            if (stats) {
+                if (this->_converged(&accumulation[pixel * 3], stats->luminanceSquares[pixel], stats->sampleCounts[pixel])) continue;
+                firstSample = static_cast<int>(stats->sampleCounts[pixel]);
             }
 
-            auto scale = 1.0 / samplesPerPixel;
-            auto r = pixel_color.x() * scale;
-            auto g = pixel_color.y() * scale;
-            auto b = pixel_color.z() * scale;
+            for (int sample = firstSample; sample < firstSample + samplesPerPixel; sample++) {
+                sampler->startPixelSample(i, j, sample);
+                tracer.addPath(i, j, sample, this->_getRay(i, j, *sampler));
+            }
 
-            r = this->_linearToGamma(r);
-            g = this->_linearToGamma(g);
-            b = this->_linearToGamma(b);
+            pixels.push_back(pixel);
+        }
+    }
 
-            int rbyte = int(256 * std::clamp(r, 0.0, 0.999));
-            int gbyte = int(256 * std::clamp(g, 0.0, 0.999));
-            int bbyte = int(256 * std::clamp(b, 0.0, 0.999));
+    uint64_t rays = 0;
+    bool finished = tracer.trace(*this, world, rays, cancelled);
 
-            int pixel_index = ((this->_imageHeight - 1 - j) * imageWidth + i) * 3;
-            pixels[pixel_index + 0] = rbyte;
-            pixels[pixel_index + 1] = gbyte;
-            pixels[pixel_index + 2] = bbyte;
+    if (context) context->rays += rays;
+    if (!finished) return false;
+
+    size_t path = 0;
+
+    for (size_t pixel : pixels) {
+        Color pixel_color(0, 0, 0);
+        double luminanceSquares = 0.0;
+        FirstHit hitSum;
+
+        for (int sample = 0; sample < samplesPerPixel; sample++, path++) {
+            Color sampleColor = tracer.radiance(path);
+            double luminance = _luminance(sampleColor);
+
+            pixel_color += sampleColor;
+            luminanceSquares += luminance * luminance;
+
+            if (aovs) {
+                hitSum.albedo += tracer.albedo(path);
+                hitSum.normal += tracer.normal(path);
+                hitSum.depth += tracer.depth(path);
+            }
         }
+
+        this->_accumulatePixel(pixel, pixel_color, luminanceSquares, hitSum, accumulation, stats, aovs);
     }
+
+    if (context) context->pixelsSampled += pixels.size();
+
+    return true;
+}
+
+void CameraWithLights::_accumulatePixel(size_t pixel, const Color& color, double luminanceSquares, const FirstHit& hitSum, std::vector<float>& accumulation, PixelStats* stats, AovBuffers* aovs) const
+{
+    float* sum = &accumulation[pixel * 3];
+
+    sum[0] += static_cast<float>(color.x());
+    sum[1] += static_cast<float>(color.y());
+    sum[2] += static_cast<float>(color.z());
+
+    if (aovs) {
+        for (int c = 0; c < 3; c++) {
+            aovs->albedo[pixel * 3 + c] += static_cast<float>(hitSum.albedo[c]);
+            aovs->normal[pixel * 3 + c] += static_cast<float>(hitSum.normal[c]);
+        }
+        aovs->depth[pixel] += static_cast<float>(hitSum.depth);
+    }
+
+    if (stats) {
+        stats->luminanceSquares[pixel] += static_cast<float>(luminanceSquares);
+        stats->sampleCounts[pixel] += samplesPerPixel;
+    }
+}
+
+void CameraWithLights::PixelStats::reset(size_t pixelCount)
+{
+    this->luminanceSquares.assign(pixelCount, 0.0f);
+    this->sampleCounts.assign(pixelCount, 0);
+}
+
+void CameraWithLights::AovBuffers::reset(size_t pixelCount)
+{
+    this->albedo.assign(pixelCount * 3, 0.0f);
+    this->normal.assign(pixelCount * 3, 0.0f);
+    this->depth.assign(pixelCount, 0.0f);
+}
+
+// Compares the standard error of the mean luminance against noiseThreshold after the
+// gamma-2 display transform, whose slope 1 / (2 sqrt(mean)) keeps dark pixels from being
+// judged by a relative error they could never reach.
+bool CameraWithLights::_converged(const float* sum, float luminanceSquares, uint32_t sampleCount) const
+{
+    if (sampleCount < static_cast<uint32_t>(std::max(2, this->minAdaptiveSamples))) return false;
+
+    double n = sampleCount;
+    double mean = _luminance(Color(sum[0], sum[1], sum[2])) / n;
+    double variance = std::max(0.0, (luminanceSquares - n * mean * mean) / (n - 1.0));
+    double standardError = std::sqrt(variance / n);
+    double displayError = standardError / (2.0 * std::sqrt(std::max(mean, 1e-4)));
+
+    return displayError < this->noiseThreshold;
 }
 
 void CameraWithLights::_initialize()
 {
-    this->_imageHeight = int(imageWidth / aspectRatio);
-    this->_imageHeight = (this->_imageHeight < 1) ? 1 : this->_imageHeight;
+    this->_imageHeight = this->imageHeight();
 
     this->_pixelSamplesScale = 1.0 / samplesPerPixel;
 
@@ -59,15 +296,16 @@ void CameraWithLights::_initialize()
 
     this->_pixelDeltaU = viewportU / imageWidth;
     this->_pixelDeltaV = viewportV / this->_imageHeight;
+    this->_pixelSpread = this->_pixelDeltaV.length() / this->_focusDist;
 
     auto viewportUpperLeft = this->_center - (this->_focusDist * this->_w) - viewportU / 2 - viewportV / 2;
 
     this->_pixel00Loc = viewportUpperLeft + 0.5 * (this->_pixelDeltaU + this->_pixelDeltaV);
 }
 
-Ray CameraWithLights::_getRay(int i, int j) const
+Ray CameraWithLights::_getRay(int i, int j, Sampler& sampler) const
 {
-    auto offset = this->_sampleSquare();
+    auto offset = this->_sampleSquare(sampler);
     auto pixel_sample = this->_pixel00Loc + ((i + offset.x()) * this->_pixelDeltaU) + ((j + offset.y()) * this->_pixelDeltaV);
     auto ray_origin = this->_center;
     auto ray_direction = pixel_sample - ray_origin;
@@ -75,29 +313,75 @@ Ray CameraWithLights::_getRay(int i, int j) const
     return Ray(ray_origin, ray_direction);
 }
 
-Vec3 CameraWithLights::_sampleSquare() const
+Vec3 CameraWithLights::_sampleSquare(Sampler& sampler) const
 {
-    return Vec3(_randomDouble() - 0.5, this->_randomDouble() - 0.5, 0);
+    double u, v;
+    sampler.get2D(u, v);
+
+    return Vec3(u - 0.5, v - 0.5, 0);
+}
+
+const Materials& CameraWithLights::_material(const HitRecord& rec) const
+{
+    if (this->materials) return this->materials->get(rec.material);
+    return MaterialTable::fallback();
 }
 
-Color CameraWithLights::_rayColor(const Ray& r, int depth, const Hittable& world) const
+// Follows one camera path iteratively, adding each vertex's emission and direct light
+// weighted by the throughput so far. After rouletteMinDepth bounces a path survives each
+// bounce with a probability equal to its throughput's largest component (clamped), and
+// survivors are reweighted by its inverse, so dim paths end early without bias.
+// firstHit, when given, receives the albedo, normal and distance of the camera ray's
+// hit. Emitters report their emission and misses the background as albedo.
+// Each hit's footprint is the pixel's cone grown over the path length so far; the extra
+// spread of rough bounces is ignored, so textures are filtered conservatively.
+Color CameraWithLights::_rayColor(const Ray& cameraRay, const Hittable& world, uint64_t& rayCount, FirstHit* firstHit) const
 {
-    if (depth <= 0) return Color(0, 0, 0);
+    Color radiance(0, 0, 0);
+    Color throughput(1, 1, 1);
+    Ray r = cameraRay;
+    bool useLights = lights && !lights->lights.empty();
+    double coneWidth = 0.0;
+
+    for (int bounce = 0; bounce < maxDepth; bounce++) {
+        rayCount++;
+
+        HitRecord rec;
+
+        if (!world.hit(r, Interval(0.001, INFINITY), rec)) {
+            Color background = this->_background(r);
 
-    HitRecord rec;
+            if (firstHit && bounce == 0) {
+                firstHit->albedo = background;
+                firstHit->normal = Vec3(0, 0, 0);
+                firstHit->depth = 0.0;
+            }
+
+            radiance += throughput * background;
+            break;
+        }
+
+        coneWidth += this->_pixelSpread * rec.t * r.direction().length();
+        rec.footprint = coneWidth;
 
-    if (world.hit(r, Interval(0.001, INFINITY), rec)) {
         Ray scattered;
         Color attenuation;
-        Color emitted = rec.mat->emitted();
+        const Materials& material = this->_material(rec);
+        Color emitted = material.emitted();
 
-        if (!rec.mat->scatter(r, rec, attenuation, scattered)) {
-            return emitted;
+        bool scatters = material.scatter(r, rec, attenuation, scattered);
+
+        if (firstHit && bounce == 0) {
+            firstHit->albedo = scatters ? attenuation : emitted;
+            firstHit->normal = rec.normal;
+            firstHit->depth = rec.t * r.direction().length();
         }
 
-        Color indirectLight = attenuation * this->_rayColor(scattered, depth - 1, world);
+        radiance += throughput * emitted;
+
+        if (!scatters) break;
 
-        if (lights && !lights->lights.empty()) {
+        if (useLights) {
             Vec3 view_dir = unitVector(-r.direction());
             Color albedo = attenuation;
 
@@ -111,13 +395,28 @@ Color CameraWithLights::_rayColor(const Ray& r, int depth, const Hittable& world
                     world
                 );
 
-            return emitted + directLight + indirectLight * 0.3;
+            radiance += throughput * directLight;
+            throughput = throughput * attenuation * 0.3;
+        } else {
+            throughput = throughput * attenuation;
         }
-        else {
-            return emitted + indirectLight;
+
+        if (this->russianRoulette && bounce + 1 >= this->rouletteMinDepth) {
+            double survival = std::clamp(std::max({throughput.x(), throughput.y(), throughput.z()}), 0.0, 0.95);
+
+            if (survival <= 0.0 || Random::uniform() >= survival) break;
+
+            throughput /= survival;
         }
+
+        r = scattered;
     }
 
+    return radiance;
+}
+
+Color CameraWithLights::_background(const Ray& r) const
+{
     if (this->skybox && this->skybox->isLoaded()) {
         return this->skybox->sample(r.direction());
     }
@@ -129,9 +428,23 @@ Color CameraWithLights::_rayColor(const Ray& r, int depth, const Hittable& world
          + a * Color(0.5, 0.7, 1.0);
 }
 
-double CameraWithLights::_randomDouble()
+double CameraWithLights::_luminance(const Color& color)
+{
+    return 0.2126 * color.x() + 0.7152 * color.y() + 0.0722 * color.z();
+}
+
+// Blue (few samples) through green to red (the cap).
+void CameraWithLights::_heatColor(double t, unsigned char* rgb)
 {
-    return std::rand() / (RAND_MAX + 1.0);
+    t = std::clamp(t, 0.0, 1.0);
+
+    double r = std::max(0.0, 2.0 * t - 1.0);
+    double g = 1.0 - std::abs(2.0 * t - 1.0);
+    double b = std::max(0.0, 1.0 - 2.0 * t);
+
+    rgb[0] = static_cast<unsigned char>(255 * r);
+    rgb[1] = static_cast<unsigned char>(255 * g);
+    rgb[2] = static_cast<unsigned char>(255 * b);
 }
 
 double CameraWithLights::_degreesToRadians(double degrees)
@@ -139,6 +452,12 @@ double CameraWithLights::_degreesToRadians(double degrees)
     return degrees * M_PI / 180.0;
 }
 
+unsigned char CameraWithLights::_toByte(float sum, double scale)
+{
+    double value = _linearToGamma(sum * scale);
+    return static_cast<unsigned char>(int(256 * std::clamp(value, 0.0, 0.999)));
+}
+
 double CameraWithLights::_linearToGamma(double linear_component)
 {
     if (linear_component > 0)
@@ -0,0 +1,100 @@
+#include "Denoiser.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const float kernel[5] = {1.0f / 16.0f, 1.0f / 4.0f, 3.0f / 8.0f, 1.0f / 4.0f, 1.0f / 16.0f};
+    const float albedoEpsilon = 1e-3f;
+}
+
+void Denoiser::Frame::resize(int frameWidth, int frameHeight)
+{
+    size_t pixelCount = static_cast<size_t>(frameWidth) * frameHeight;
+
+    this->width = frameWidth;
+    this->height = frameHeight;
+    this->color.resize(pixelCount * 3);
+    this->albedo.resize(pixelCount * 3);
+    this->normal.resize(pixelCount * 3);
+    this->depth.resize(pixelCount);
+}
+
+void Denoiser::denoise(const Frame& frame, std::vector<float>& output, ThreadPool* pool) const
+{
+    size_t valueCount = static_cast<size_t>(frame.width) * frame.height * 3;
+    std::vector<float> current(valueCount);
+    std::vector<float> next(valueCount);
+
+    for (size_t i = 0; i < valueCount; i++)
+        current[i] = frame.color[i] / std::max(frame.albedo[i], albedoEpsilon);
+
+    float sigma = this->colorSigma;
+
+    for (int iteration = 0; iteration < this->iterations; iteration++) {
+        int step = 1 << iteration;
+
+        auto filterRow = [&](size_t y, size_t) {
+            this->_filterRow(frame, static_cast<int>(y), step, sigma, current, next);
+        };
+
+        if (pool) pool->parallelFor(frame.height, filterRow);
+        else for (int y = 0; y < frame.height; y++) filterRow(y, 0);
+
+        current.swap(next);
+        sigma *= 0.5f;
+    }
+
+    output.resize(valueCount);
+    for (size_t i = 0; i < valueCount; i++)
+        output[i] = current[i] * std::max(frame.albedo[i], albedoEpsilon);
+}
+
+void Denoiser::_filterRow(const Frame& frame, int y, int step, float colorSigma, const std::vector<float>& input, std::vector<float>& output) const
+{
+    float colorScale = 1.0f / std::max(colorSigma * colorSigma, 1e-8f);
+    float normalScale = 1.0f / std::max(this->normalSigma * this->normalSigma, 1e-8f);
+
+    for (int x = 0; x < frame.width; x++) {
+        size_t center = static_cast<size_t>(y) * frame.width + x;
+        const float* c = &input[center * 3];
+        const float* n = &frame.normal[center * 3];
+        float z = frame.depth[center];
+        float depthScale = 1.0f / std::max(this->depthSigma * z * step, 1e-4f);
+
+        float sum[3] = {0.0f, 0.0f, 0.0f};
+        float weightSum = 0.0f;
+
+        for (int ky = -2; ky <= 2; ky++) {
+            int sy = y + ky * step;
+            if (sy < 0 || sy >= frame.height) continue;
+
+            for (int kx = -2; kx <= 2; kx++) {
+                int sx = x + kx * step;
+                if (sx < 0 || sx >= frame.width) continue;
+
+                size_t tap = static_cast<size_t>(sy) * frame.width + sx;
+                const float* tc = &input[tap * 3];
+                const float* tn = &frame.normal[tap * 3];
+
+                float dc = (tc[0] - c[0]) * (tc[0] - c[0]) + (tc[1] - c[1]) * (tc[1] - c[1]) + (tc[2] - c[2]) * (tc[2] - c[2]);
+                float dn = (tn[0] - n[0]) * (tn[0] - n[0]) + (tn[1] - n[1]) * (tn[1] - n[1]) + (tn[2] - n[2]) * (tn[2] - n[2]);
+                float dz = std::abs(frame.depth[tap] - z);
+
+                float weight = kernel[kx + 2] * kernel[ky + 2]
+                    * std::exp(-dc * colorScale - dn * normalScale - dz * depthScale);
+
+                sum[0] += weight * tc[0];
+                sum[1] += weight * tc[1];
+                sum[2] += weight * tc[2];
+                weightSum += weight;
+            }
+        }
+
+        // The centre tap always contributes, so weightSum is never zero.
+        float* out = &output[center * 3];
+        out[0] = sum[0] / weightSum;
+        out[1] = sum[1] / weightSum;
+        out[2] = sum[2] / weightSum;
+    }
+}
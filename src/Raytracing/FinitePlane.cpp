@@ -0,0 +1,71 @@
+#include "FinitePlane.hpp"
+
+FinitePlane::FinitePlane(const glm::mat4& objectToWorld, double halfWidth, double halfHeight, uint32_t material)
+    : _objectToWorld(objectToWorld), _worldToObject(glm::inverse(objectToWorld))
+{
+    this->_halfWidth = std::fabs(halfWidth);
+    this->_halfHeight = std::fabs(halfHeight);
+    this->_material = material;
+    this->_normal = unitVector(this->_worldToObject.normal(Vec3(0, 0, 1)));
+
+    double area = cross(
+        this->_objectToWorld.vector(Vec3(2.0 * this->_halfWidth, 0, 0)),
+        this->_objectToWorld.vector(Vec3(0, 2.0 * this->_halfHeight, 0))
+    ).length();
+    this->_uvDensity = area > 0.0 ? 1.0 / std::sqrt(area) : 0.0;
+
+    this->_bbox = this->_objectToWorld.bounds(Aabb(
+        point3(-this->_halfWidth, -this->_halfHeight, 0),
+        point3(this->_halfWidth, this->_halfHeight, 0)
+    ));
+}
+
+bool FinitePlane::_intersect(const Ray& r, Interval rayT, double& t, point3& local) const
+{
+    Ray objectRay(this->_worldToObject.point(r.origin()), this->_worldToObject.vector(r.direction()));
+
+    double dz = objectRay.direction().z();
+    if (dz == 0.0) return false;
+
+    t = -objectRay.origin().z() / dz;
+    if (!rayT.surrounds(t)) return false;
+
+    local = objectRay.at(t);
+    return std::fabs(local.x()) <= this->_halfWidth && std::fabs(local.y()) <= this->_halfHeight;
+}
+
+bool FinitePlane::hit(const Ray& r, Interval rayT, HitRecord& rec) const
+{
+    double t;
+    point3 local;
+    if (!this->_intersect(r, rayT, t, local)) return false;
+
+    rec.t = t;
+    rec.p = r.at(t);
+    rec.setFaceNormal(r, this->_normal);
+    rec.material = this->_material;
+
+    // Matches the plane mesh UVs.
+    rec.u = 0.5 * local.x() / this->_halfWidth + 0.5;
+    rec.v = 0.5 - 0.5 * local.y() / this->_halfHeight;
+    rec.uvDensity = this->_uvDensity;
+
+    return true;
+}
+
+bool FinitePlane::occluded(const Ray& r, Interval rayT) const
+{
+    double t;
+    point3 local;
+    return this->_intersect(r, rayT, t, local);
+}
+
+Aabb FinitePlane::boundingBox() const
+{
+    return this->_bbox;
+}
+
+PrimitiveKind FinitePlane::primitiveKind() const
+{
+    return PrimitiveKind::Plane;
+}
@@ -5,3 +5,14 @@ void HitRecord::setFaceNormal(const Ray& r, const Vec3& outwardNormal)
     frontFace = dot(r.direction(), outwardNormal) < 0;
     normal = frontFace ? outwardNormal : -outwardNormal;
 }
+
+bool Hittable::occluded(const Ray& r, Interval rayT) const
+{
+    HitRecord rec;
+    return this->hit(r, rayT, rec);
+}
+
+PrimitiveKind Hittable::primitiveKind() const
+{
+    return PrimitiveKind::Other;
+}
@@ -32,6 +32,14 @@ bool HittableList::hit(const Ray& r, Interval rayT, HitRecord& rec) const
     return hitAnything;
 }
 
+bool HittableList::occluded(const Ray& r, Interval rayT) const
+{
+    for (const auto& object : this->objects)
+        if (object->occluded(r, rayT)) return true;
+
+    return false;
+}
+
 Aabb HittableList::boundingBox() const
 {
     if (this->objects.empty()) return Aabb(point3(0, 0, 0), point3(0, 0, 0));
@@ -0,0 +1,56 @@
+#include "Instance.hpp"
+
+Instance::Instance(std::shared_ptr<Hittable> object, const glm::mat4& objectToWorld, uint32_t material)
+    : _object(object), _objectRef(object.get()), _material(material), _objectToWorld(objectToWorld), _worldToObject(glm::inverse(objectToWorld))
+{
+    this->_bbox = this->_objectToWorld.bounds(this->_object->boundingBox());
+    this->_volumeScale = std::fabs(this->_objectToWorld.determinant());
+}
+
+bool Instance::hit(const Ray& r, Interval rayT, HitRecord& rec) const
+{
+    // The direction is not renormalised, so t means the same thing in both spaces.
+    Ray objectRay(
+        this->_worldToObject.point(r.origin()),
+        this->_worldToObject.vector(r.direction())
+    );
+
+    if (!this->_objectRef.hit(objectRay, rayT, rec)) return false;
+
+    rec.p = this->_objectToWorld.point(rec.p);
+    Vec3 normal = this->_worldToObject.normal(rec.normal);
+    rec.normal = unitVector(normal);
+
+    // A surface element with unit normal n grows by det(M) |M^-T n| under the transform.
+    double areaScale = this->_volumeScale * normal.length();
+    rec.uvDensity = areaScale > 0.0 ? rec.uvDensity / std::sqrt(areaScale) : 0.0;
+
+    if (this->_material != MaterialTable::invalidIndex) rec.material = this->_material;
+
+    return true;
+}
+
+bool Instance::occluded(const Ray& r, Interval rayT) const
+{
+    Ray objectRay(
+        this->_worldToObject.point(r.origin()),
+        this->_worldToObject.vector(r.direction())
+    );
+
+    return this->_objectRef.occluded(objectRay, rayT);
+}
+
+Aabb Instance::boundingBox() const
+{
+    return this->_bbox;
+}
+
+PrimitiveKind Instance::primitiveKind() const
+{
+    return PrimitiveKind::Instance;
+}
+
+const std::shared_ptr<Hittable>& Instance::object() const
+{
+    return this->_object;
+}
@@ -1,35 +1,5 @@
 #include "Interval.hpp"
 
-Interval::Interval() : min(+INFINITY), max(-INFINITY) {}
-
-Interval::Interval(double min, double max)
-{
-    this->min = min;
-    this->max = max;
-}
-
-double Interval::size() const
-{
-    return this->max - this->min;
-}
-
-bool Interval::contains(double x) const
-{
-    return this->min <= x && x <= this->max;
-}
-
-bool Interval::surrounds(double x) const
-{
-    return this->min < x && x < this->max;
-}
-
-double Interval::clamp(double x) const
-{
-    if (x < this->min) return this->min;
-    if (x > this->max) return this->max;
-    return x;
-}
-
 const Interval Interval::empty = Interval(+INFINITY, -INFINITY);
 const Interval Interval::universe = Interval(-INFINITY, +INFINITY);
 
@@ -1,4 +1,5 @@
 #include "Lights.hpp"
+#include "Random.hpp"
 
 RtLight::RtLight(const LightSource& light, const glm::mat4& transform)
 {
@@ -16,6 +17,11 @@ RtLight::RtLight(const LightSource& light, const glm::mat4& transform)
     this->attenuation = light.attenuation;
 }
 
+double RtLight::power() const
+{
+    return this->intensity * (0.2126 * this->colorValue.x() + 0.7152 * this->colorValue.y() + 0.0722 * this->colorValue.z());
+}
+
 Color RtLight::computeLighting(
     const point3& hitPoint,
     const Vec3& normal,
@@ -23,6 +29,23 @@ Color RtLight::computeLighting(
     const Color& albedo,
     double shininess,
     const Hittable& world
+) const {
+    Color result = this->unshadowedLighting(hitPoint, normal, viewDir, albedo, shininess);
+
+    if (result.x() == 0 && result.y() == 0 && result.z() == 0)
+        return result;
+    if (!this->visible(hitPoint, world))
+        return Color(0, 0, 0);
+
+    return result;
+}
+
+Color RtLight::unshadowedLighting(
+    const point3& hitPoint,
+    const Vec3& normal,
+    const Vec3& viewDir,
+    const Color& albedo,
+    double shininess
 ) const {
     Color result(0, 0, 0);
 
@@ -31,11 +54,6 @@ Color RtLight::computeLighting(
     else if (this->type == LightType::DIRECTIONAL) {
         Vec3 lightDir = unitVector(-this->direction);
 
-        Ray shadowRay(hitPoint, lightDir);
-        HitRecord shadowRec;
-        if (world.hit(shadowRay, Interval(0.001, INFINITY), shadowRec))
-            return Color(0, 0, 0);
-
         double diff = std::fmax(0.0, dot(normal, lightDir));
         Color diffuse = this->colorValue * this->intensity * diff * albedo;
 
@@ -49,11 +67,6 @@ Color RtLight::computeLighting(
         double distance = lightDir.length();
         lightDir = lightDir / distance;
 
-        Ray shadowRay(hitPoint, lightDir);
-        HitRecord shadowRec;
-        if (world.hit(shadowRay, Interval(0.001, distance - 0.001), shadowRec))
-            return Color(0, 0, 0);
-
         double att = 1.0 / (1.0 + this->attenuation * distance * distance);
 
         double diff = std::fmax(0.0, dot(normal, lightDir));
@@ -74,11 +87,6 @@ Color RtLight::computeLighting(
 
         if (theta < cutoff) return Color(0, 0, 0);
 
-        Ray shadowRay(hitPoint, lightDir);
-        HitRecord shadowRec;
-        if (world.hit(shadowRay, Interval(0.001, distance - 0.001), shadowRec))
-            return Color(0, 0, 0);
-
         double att = 1.0 / (1.0 + this->attenuation * distance * distance);
 
         double epsilon = 0.1;
@@ -98,6 +106,31 @@ Color RtLight::computeLighting(
     return result;
 }
 
+Ray RtLight::shadowRay(const point3& hitPoint, double& tMax) const
+{
+    if (this->type == LightType::DIRECTIONAL) {
+        tMax = INFINITY;
+        return Ray(hitPoint, unitVector(-this->direction));
+    }
+
+    Vec3 lightDir = this->position - hitPoint;
+    double distance = lightDir.length();
+
+    tMax = distance - 0.001;
+    return Ray(hitPoint, lightDir / distance);
+}
+
+bool RtLight::visible(const point3& hitPoint, const Hittable& world) const
+{
+    if (this->type == LightType::AMBIENT)
+        return true;
+
+    double tMax;
+    Ray ray = this->shadowRay(hitPoint, tMax);
+
+    return !world.occluded(ray, Interval(0.001, tMax));
+}
+
 
 void sceneLights::add(const RtLight& light)
 {
@@ -109,6 +142,56 @@ void sceneLights::clear()
     this->lights.clear();
 }
 
+// Vose's alias method: every light is drawn in O(1) from one uniform number.
+void sceneLights::buildSamplingTable()
+{
+    this->_sampledLights.clear();
+    this->_ambientLights.clear();
+
+    double totalPower = 0.0;
+
+    for (uint32_t i = 0; i < this->lights.size(); i++) {
+        if (this->lights[i].type == LightType::AMBIENT) {
+            this->_ambientLights.push_back(i);
+        } else if (this->lights[i].power() > 0.0) {
+            this->_sampledLights.push_back(i);
+            totalPower += this->lights[i].power();
+        }
+    }
+
+    size_t count = this->_sampledLights.size();
+    std::vector<double> scaled(count);
+    std::vector<uint32_t> small, large;
+
+    this->_pdf.resize(count);
+    this->_probability.assign(count, 1.0);
+    this->_alias.resize(count);
+
+    for (uint32_t i = 0; i < count; i++) {
+        this->_pdf[i] = this->lights[this->_sampledLights[i]].power() / totalPower;
+        this->_alias[i] = i;
+        scaled[i] = this->_pdf[i] * count;
+        (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
+
+    while (!small.empty() && !large.empty()) {
+        uint32_t less = small.back();
+        uint32_t more = large.back();
+        small.pop_back();
+
+        this->_probability[less] = scaled[less];
+        this->_alias[less] = more;
+
+        scaled[more] -= 1.0 - scaled[less];
+        if (scaled[more] < 1.0) {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+
+    this->_tableLightCount = this->lights.size();
+}
+
 Color sceneLights::computeTotalLighting(
     const point3& hitPoint,
     const Vec3& normal,
@@ -117,6 +200,14 @@ Color sceneLights::computeTotalLighting(
     double shininess,
     const Hittable& world
 ) const {
+    if (this->sampling != LightSampling::All && this->_tableLightCount == this->lights.size()) {
+        Color shadowed(0, 0, 0);
+        Color ambient = this->_selectLights(hitPoint, normal, viewDir, albedo, shininess, [&](const RtLight& light, const Color& contribution) {
+            if (light.visible(hitPoint, world)) shadowed += contribution;
+        });
+        return ambient + shadowed;
+    }
+
     Color total(0, 0, 0);
 
     for (const auto& light : this->lights)
@@ -124,3 +215,127 @@ Color sceneLights::computeTotalLighting(
 
     return total;
 }
+
+Color sceneLights::sampleLighting(
+    const point3& hitPoint,
+    const Vec3& normal,
+    const Vec3& viewDir,
+    const Color& albedo,
+    double shininess,
+    std::vector<LightSample>& samples
+) const {
+    return this->_selectLights(hitPoint, normal, viewDir, albedo, shininess, [&](const RtLight& light, const Color& contribution) {
+        samples.push_back({&light, contribution});
+    });
+}
+
+template<typename Emit>
+Color sceneLights::_selectLights(
+    const point3& hitPoint,
+    const Vec3& normal,
+    const Vec3& viewDir,
+    const Color& albedo,
+    double shininess,
+    Emit&& emit
+) const {
+    Color ambient(0, 0, 0);
+
+    if (this->sampling == LightSampling::All || this->_tableLightCount != this->lights.size()) {
+        for (const auto& light : this->lights) {
+            Color contribution = light.unshadowedLighting(hitPoint, normal, viewDir, albedo, shininess);
+
+            if (light.type == LightType::AMBIENT) ambient += contribution;
+            else if (contribution.x() != 0 || contribution.y() != 0 || contribution.z() != 0) emit(light, contribution);
+        }
+        return ambient;
+    }
+
+    for (uint32_t index : this->_ambientLights)
+        ambient += this->lights[index].unshadowedLighting(hitPoint, normal, viewDir, albedo, shininess);
+
+    if (this->_sampledLights.empty()) return ambient;
+
+    if (this->sampling == LightSampling::Power)
+        this->_selectByPower(hitPoint, normal, viewDir, albedo, shininess, emit);
+    else
+        this->_selectResampled(hitPoint, normal, viewDir, albedo, shininess, emit);
+
+    return ambient;
+}
+
+uint32_t sceneLights::_sampleLight(double& pdf) const
+{
+    size_t count = this->_sampledLights.size();
+    double u = Random::uniform() * count;
+    uint32_t slot = std::min(static_cast<uint32_t>(u), static_cast<uint32_t>(count - 1));
+    uint32_t entry = (u - slot) < this->_probability[slot] ? slot : this->_alias[slot];
+
+    pdf = this->_pdf[entry];
+    return this->_sampledLights[entry];
+}
+
+template<typename Emit>
+void sceneLights::_selectByPower(
+    const point3& hitPoint,
+    const Vec3& normal,
+    const Vec3& viewDir,
+    const Color& albedo,
+    double shininess,
+    Emit&& emit
+) const {
+    int samples = std::max(1, this->lightSamples);
+
+    for (int s = 0; s < samples; s++) {
+        double pdf;
+        const RtLight& light = this->lights[this->_sampleLight(pdf)];
+        Color contribution = light.unshadowedLighting(hitPoint, normal, viewDir, albedo, shininess);
+
+        if (contribution.x() != 0 || contribution.y() != 0 || contribution.z() != 0)
+            emit(light, contribution / (pdf * samples));
+    }
+}
+
+// Each reservoir streams candidateCount power-sampled candidates, keeps one with
+// probability proportional to target / pdf, where target is the luminance of its
+// unshadowed contribution, and weights the survivor by the mean of those ratios over its
+// target. Only the survivor is shadow-tested.
+template<typename Emit>
+void sceneLights::_selectResampled(
+    const point3& hitPoint,
+    const Vec3& normal,
+    const Vec3& viewDir,
+    const Color& albedo,
+    double shininess,
+    Emit&& emit
+) const {
+    int samples = std::max(1, this->lightSamples);
+    int candidates = std::max(1, this->candidateCount);
+
+    for (int s = 0; s < samples; s++) {
+        double weightSum = 0.0;
+        const RtLight* chosen = nullptr;
+        Color chosenContribution;
+        double chosenTarget = 0.0;
+
+        for (int c = 0; c < candidates; c++) {
+            double pdf;
+            const RtLight& light = this->lights[this->_sampleLight(pdf)];
+            Color contribution = light.unshadowedLighting(hitPoint, normal, viewDir, albedo, shininess);
+            double target = 0.2126 * contribution.x() + 0.7152 * contribution.y() + 0.0722 * contribution.z();
+
+            if (target <= 0.0) continue;
+
+            double weight = target / pdf;
+            weightSum += weight;
+
+            if (Random::uniform() * weightSum < weight) {
+                chosen = &light;
+                chosenContribution = contribution;
+                chosenTarget = target;
+            }
+        }
+
+        if (chosen)
+            emit(*chosen, chosenContribution * (weightSum / (candidates * chosenTarget * samples)));
+    }
+}
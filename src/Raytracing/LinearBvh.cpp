@@ -0,0 +1,422 @@
+#include "LinearBvh.hpp"
+
+void LinearBvh::build(const std::vector<Aabb>& primitiveBounds, ThreadPool* threadPool)
+{
+    auto startTime = std::chrono::steady_clock::now();
+
+    this->clear();
+
+    if (primitiveBounds.empty()) return;
+
+    std::vector<BuildPrimitive> primitives(primitiveBounds.size());
+
+    for (size_t i = 0; i < primitiveBounds.size(); i++) {
+        const Aabb& box = primitiveBounds[i];
+
+        primitives[i].bounds = box;
+        primitives[i].centroid = point3(
+            0.5 * (box.x.min + box.x.max),
+            0.5 * (box.y.min + box.y.max),
+            0.5 * (box.z.min + box.z.max)
+        );
+        primitives[i].index = static_cast<uint32_t>(i);
+    }
+
+    this->_nodes.reserve(2 * primitives.size());
+
+    bool parallel = threadPool && threadPool->size() > 1 && primitives.size() >= 2 * parallelThreshold;
+
+    if (!parallel) {
+        _buildSubtree(primitives, 0, primitives.size(), 0, this->_nodes);
+    } else {
+        // Split the top levels serially until the ranges are small enough to give every
+        // worker several subtrees, build those concurrently, then splice them in order.
+        size_t subtreeSize = std::max(parallelThreshold, primitives.size() / (4 * threadPool->size()));
+        std::vector<TopNode> top;
+        std::vector<Subtree> subtrees;
+
+        this->_buildTop(primitives, 0, primitives.size(), 0, subtreeSize, top, subtrees);
+
+        threadPool->parallelFor(subtrees.size(), [&](size_t index, size_t) {
+            Subtree& subtree = subtrees[index];
+            _buildSubtree(primitives, subtree.start, subtree.end, subtree.depth, subtree.nodes);
+        });
+
+        this->_emitTop(top, 0, subtrees);
+    }
+
+    // Leaves address the partitioned primitive array directly.
+    this->_primitiveIndices.resize(primitives.size());
+    for (size_t i = 0; i < primitives.size(); i++)
+        this->_primitiveIndices[i] = primitives[i].index;
+
+    this->_computeStats();
+    this->_stats.buildMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void LinearBvh::clear()
+{
+    this->_nodes.clear();
+    this->_primitiveIndices.clear();
+    this->_stats = BuildStats();
+}
+
+bool LinearBvh::empty() const
+{
+    return this->_nodes.empty();
+}
+
+Aabb LinearBvh::bounds() const
+{
+    if (this->_nodes.empty()) return Aabb(point3(0, 0, 0), point3(0, 0, 0));
+
+    const LinearBvhNode& root = this->_nodes[0];
+
+    return Aabb(
+        point3(root.boundsMin[0], root.boundsMin[1], root.boundsMin[2]),
+        point3(root.boundsMax[0], root.boundsMax[1], root.boundsMax[2])
+    );
+}
+
+size_t LinearBvh::nodeCount() const
+{
+    return this->_nodes.size();
+}
+
+const std::vector<LinearBvhNode>& LinearBvh::nodes() const
+{
+    return this->_nodes;
+}
+
+const std::vector<uint32_t>& LinearBvh::primitiveIndices() const
+{
+    return this->_primitiveIndices;
+}
+
+const LinearBvh::BuildStats& LinearBvh::buildStats() const
+{
+    return this->_stats;
+}
+
+int LinearBvh::_buildTop(
+    std::vector<BuildPrimitive>& primitives,
+    size_t start,
+    size_t end,
+    int depth,
+    size_t subtreeSize,
+    std::vector<TopNode>& top,
+    std::vector<Subtree>& subtrees)
+{
+    int index = static_cast<int>(top.size());
+    top.emplace_back();
+
+    BinBounds bounds, centroidBounds;
+    _computeBounds(primitives, start, end, bounds, centroidBounds);
+    top[index].bounds = bounds;
+
+    size_t mid;
+    int axis;
+
+    if (end - start <= subtreeSize || !_split(primitives, start, end, depth, bounds, centroidBounds, mid, axis)) {
+        top[index].subtree = static_cast<int>(subtrees.size());
+        subtrees.push_back(Subtree{start, end, depth, {}});
+        return index;
+    }
+
+    int left = this->_buildTop(primitives, start, mid, depth + 1, subtreeSize, top, subtrees);
+    int right = this->_buildTop(primitives, mid, end, depth + 1, subtreeSize, top, subtrees);
+
+    top[index].axis = static_cast<uint8_t>(axis);
+    top[index].children[0] = left;
+    top[index].children[1] = right;
+
+    return index;
+}
+
+void LinearBvh::_emitTop(const std::vector<TopNode>& top, int index, std::vector<Subtree>& subtrees)
+{
+    const TopNode& topNode = top[index];
+
+    if (topNode.subtree >= 0) {
+        Subtree& subtree = subtrees[topNode.subtree];
+        uint32_t base = static_cast<uint32_t>(this->_nodes.size());
+
+        for (LinearBvhNode& node : subtree.nodes) {
+            if (!node.isLeaf()) node.offset += base;
+            this->_nodes.push_back(node);
+        }
+
+        subtree.nodes.clear();
+        subtree.nodes.shrink_to_fit();
+        return;
+    }
+
+    uint32_t nodeIndex = static_cast<uint32_t>(this->_nodes.size());
+    this->_nodes.emplace_back();
+    _storeBounds(this->_nodes[nodeIndex], topNode.bounds);
+
+    this->_emitTop(top, topNode.children[0], subtrees);
+    uint32_t secondChild = static_cast<uint32_t>(this->_nodes.size());
+    this->_emitTop(top, topNode.children[1], subtrees);
+
+    LinearBvhNode& node = this->_nodes[nodeIndex];
+    node.offset = secondChild;
+    node.primitiveCount = 0;
+    node.axis = topNode.axis;
+}
+
+uint32_t LinearBvh::_buildSubtree(
+    std::vector<BuildPrimitive>& primitives,
+    size_t start,
+    size_t end,
+    int depth,
+    std::vector<LinearBvhNode>& nodes)
+{
+    uint32_t nodeIndex = static_cast<uint32_t>(nodes.size());
+    nodes.emplace_back();
+
+    BinBounds bounds, centroidBounds;
+    _computeBounds(primitives, start, end, bounds, centroidBounds);
+    _storeBounds(nodes[nodeIndex], bounds);
+
+    size_t mid;
+    int axis;
+
+    if (!_split(primitives, start, end, depth, bounds, centroidBounds, mid, axis)) {
+        LinearBvhNode& leaf = nodes[nodeIndex];
+        leaf.offset = static_cast<uint32_t>(start);
+        leaf.primitiveCount = static_cast<uint16_t>(end - start);
+        leaf.axis = 0;
+        return nodeIndex;
+    }
+
+    _buildSubtree(primitives, start, mid, depth + 1, nodes);
+    uint32_t secondChild = _buildSubtree(primitives, mid, end, depth + 1, nodes);
+
+    LinearBvhNode& node = nodes[nodeIndex];
+    node.offset = secondChild;
+    node.primitiveCount = 0;
+    node.axis = static_cast<uint8_t>(axis);
+
+    return nodeIndex;
+}
+
+// Evaluates binCount - 1 candidate planes per axis with the surface area heuristic and
+// partitions [start, end) around the cheapest one. Returns false when a leaf costs less.
+bool LinearBvh::_split(
+    std::vector<BuildPrimitive>& primitives,
+    size_t start,
+    size_t end,
+    int depth,
+    const BinBounds& bounds,
+    const BinBounds& centroidBounds,
+    size_t& mid,
+    int& axis)
+{
+    size_t count = end - start;
+
+    if (count <= 1) return false;
+
+    int longestAxis = 0;
+    for (int a = 1; a < 3; a++) {
+        if (centroidBounds.hi[a] - centroidBounds.lo[a] > centroidBounds.hi[longestAxis] - centroidBounds.lo[longestAxis])
+            longestAxis = a;
+    }
+
+    auto medianSplit = [&]() {
+        axis = longestAxis;
+        mid = start + count / 2;
+        std::nth_element(
+            primitives.begin() + start,
+            primitives.begin() + mid,
+            primitives.begin() + end,
+            [a = axis](const BuildPrimitive& lhs, const BuildPrimitive& rhs) {
+                return lhs.centroid[a] < rhs.centroid[a];
+            }
+        );
+        return true;
+    };
+
+    // Past half the stack budget, balanced splits keep the remaining depth logarithmic.
+    if (depth >= maxDepth / 2) {
+        if (count <= static_cast<size_t>(maxLeafSize)) return false;
+        return medianSplit();
+    }
+
+    double bestCost = INFINITY;
+    int bestAxis = -1;
+    int bestBin = 0;
+
+    for (int a = 0; a < 3; a++) {
+        double extent = centroidBounds.hi[a] - centroidBounds.lo[a];
+        if (extent <= 0.0) continue;
+
+        BinBounds binBounds[binCount];
+        size_t binCounts[binCount] = {};
+        double scale = binCount / extent;
+
+        for (size_t i = start; i < end; i++) {
+            int bin = std::min(binCount - 1, static_cast<int>((primitives[i].centroid[a] - centroidBounds.lo[a]) * scale));
+            binCounts[bin]++;
+            binBounds[bin].grow(primitives[i].bounds);
+        }
+
+        double rightArea[binCount - 1];
+        size_t rightCount[binCount - 1];
+        BinBounds accumulated;
+        size_t accumulatedCount = 0;
+
+        for (int bin = binCount - 1; bin > 0; bin--) {
+            accumulated.grow(binBounds[bin]);
+            accumulatedCount += binCounts[bin];
+            rightArea[bin - 1] = accumulated.area();
+            rightCount[bin - 1] = accumulatedCount;
+        }
+
+        accumulated = BinBounds();
+        accumulatedCount = 0;
+
+        for (int bin = 0; bin < binCount - 1; bin++) {
+            accumulated.grow(binBounds[bin]);
+            accumulatedCount += binCounts[bin];
+
+            if (accumulatedCount == 0 || rightCount[bin] == 0) continue;
+
+            double cost = accumulatedCount * accumulated.area() + rightCount[bin] * rightArea[bin];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = a;
+                bestBin = bin;
+            }
+        }
+    }
+
+    if (bestAxis < 0) {
+        // Every centroid landed in one bin (coincident primitives): nothing to gain from SAH.
+        if (count <= static_cast<size_t>(maxLeafSize)) return false;
+        return medianSplit();
+    }
+
+    double parentArea = bounds.area();
+    double splitCost = traversalCost + (parentArea > 0.0 ? intersectionCost * bestCost / parentArea : intersectionCost * count);
+    double leafCost = intersectionCost * count;
+
+    if (count <= static_cast<size_t>(maxLeafSize) && leafCost <= splitCost) return false;
+
+    double lo = centroidBounds.lo[bestAxis];
+    double scale = binCount / (centroidBounds.hi[bestAxis] - lo);
+
+    auto midIt = std::partition(
+        primitives.begin() + start,
+        primitives.begin() + end,
+        [&](const BuildPrimitive& primitive) {
+            int bin = std::min(binCount - 1, static_cast<int>((primitive.centroid[bestAxis] - lo) * scale));
+            return bin <= bestBin;
+        }
+    );
+
+    axis = bestAxis;
+    mid = static_cast<size_t>(midIt - primitives.begin());
+
+    if (mid == start || mid == end) return medianSplit();
+
+    return true;
+}
+
+void LinearBvh::_computeBounds(
+    const std::vector<BuildPrimitive>& primitives,
+    size_t start,
+    size_t end,
+    BinBounds& bounds,
+    BinBounds& centroidBounds)
+{
+    for (size_t i = start; i < end; i++) {
+        bounds.grow(primitives[i].bounds);
+        centroidBounds.grow(primitives[i].centroid);
+    }
+}
+
+// Expected cost of a random ray through the root, weighting each node by its surface
+// area relative to the root's.
+void LinearBvh::_computeStats()
+{
+    this->_stats.nodeCount = this->_nodes.size();
+
+    if (this->_nodes.empty()) return;
+
+    auto nodeArea = [](const LinearBvhNode& node) {
+        double dx = node.boundsMax[0] - node.boundsMin[0];
+        double dy = node.boundsMax[1] - node.boundsMin[1];
+        double dz = node.boundsMax[2] - node.boundsMin[2];
+        return 2.0 * (dx * dy + dy * dz + dz * dx);
+    };
+
+    double rootArea = nodeArea(this->_nodes[0]);
+    double cost = 0.0;
+
+    for (const LinearBvhNode& node : this->_nodes) {
+        double weight = rootArea > 0.0 ? nodeArea(node) / rootArea : 1.0;
+
+        if (node.isLeaf()) {
+            cost += weight * intersectionCost * node.primitiveCount;
+            this->_stats.leafCount++;
+        } else {
+            cost += weight * traversalCost;
+        }
+    }
+
+    this->_stats.sahCost = cost;
+}
+
+// Rounds outwards so the float box never clips a primitive stored in double precision.
+void LinearBvh::_storeBounds(LinearBvhNode& node, const BinBounds& box)
+{
+    for (int axis = 0; axis < 3; axis++) {
+        float lo = static_cast<float>(box.lo[axis]);
+        float hi = static_cast<float>(box.hi[axis]);
+
+        if (lo > box.lo[axis]) lo = std::nextafter(lo, -INFINITY);
+        if (hi < box.hi[axis]) hi = std::nextafter(hi, INFINITY);
+
+        node.boundsMin[axis] = lo;
+        node.boundsMax[axis] = hi;
+    }
+
+    node.pad = 0;
+}
+
+void LinearBvh::BinBounds::grow(const Aabb& box)
+{
+    for (int axis = 0; axis < 3; axis++) {
+        const Interval& interval = box.axisInterval(axis);
+        this->lo[axis] = std::min(this->lo[axis], interval.min);
+        this->hi[axis] = std::max(this->hi[axis], interval.max);
+    }
+}
+
+void LinearBvh::BinBounds::grow(const point3& p)
+{
+    for (int axis = 0; axis < 3; axis++) {
+        this->lo[axis] = std::min(this->lo[axis], p[axis]);
+        this->hi[axis] = std::max(this->hi[axis], p[axis]);
+    }
+}
+
+void LinearBvh::BinBounds::grow(const BinBounds& other)
+{
+    for (int axis = 0; axis < 3; axis++) {
+        this->lo[axis] = std::min(this->lo[axis], other.lo[axis]);
+        this->hi[axis] = std::max(this->hi[axis], other.hi[axis]);
+    }
+}
+
+double LinearBvh::BinBounds::area() const
+{
+    double dx = this->hi[0] - this->lo[0];
+    double dy = this->hi[1] - this->lo[1];
+    double dz = this->hi[2] - this->lo[2];
+
+    if (dx < 0.0 || dy < 0.0 || dz < 0.0) return 0.0;
+
+    return 2.0 * (dx * dy + dy * dz + dz * dx);
+}
@@ -1,13 +1,25 @@
 #include "Materials.hpp"
+#include "Random.hpp"
 
-Lambertian::Lambertian(const Color& albedo, ofTexture* texture)
+#include <algorithm>
+
+namespace {
+
+// Width in UV units of the ray cone where it meets the surface, stretched at grazing angles.
+double uvFootprint(const Ray& rIn, const HitRecord& rec)
+{
+    if (rec.footprint <= 0.0 || rec.uvDensity <= 0.0) return 0.0;
+
+    double cosine = std::fabs(dot(unitVector(rIn.direction()), rec.normal));
+    return rec.footprint * rec.uvDensity / std::max(cosine, 0.1);
+}
+
+}
+
+Lambertian::Lambertian(const Color& albedo, std::shared_ptr<const CpuTexture> texture)
 {
     this->_albedo = albedo;
     this->_texture = texture;
-
-    if (texture && texture->isAllocated()) {
-        texture->readToPixels(this->_cachedPixels);
-    }
 }
 
 bool Lambertian::scatter(
@@ -22,36 +34,18 @@ bool Lambertian::scatter(
 
     scattered = Ray(rec.p, scatterDirection);
 
-    if (this->_cachedPixels.isAllocated()) {
-        int x = static_cast<int>(rec.u * (this->_cachedPixels.getWidth() - 1));
-        int y = static_cast<int>(rec.v * (this->_cachedPixels.getHeight() - 1));
-        x = std::max(0, std::min(x, static_cast<int>(this->_cachedPixels.getWidth() - 1)));
-        y = std::max(0, std::min(y, static_cast<int>(this->_cachedPixels.getHeight() - 1)));
-
-        ofColor texColor = this->_cachedPixels.getColor(x, y);
-
-        attenuation = Color(
-            texColor.r / 255.0 * this->_albedo.x(),
-            texColor.g / 255.0 * this->_albedo.y(),
-            texColor.b / 255.0 * this->_albedo.z()
-        );
-    } else {
-        attenuation = this->_albedo;
-    }
+    if (this->_texture) attenuation = this->_texture->sampleFootprint(rec.u, rec.v, uvFootprint(rIn, rec)) * this->_albedo;
+    else attenuation = this->_albedo;
 
     return true;
 }
 
 
-Metal::Metal(const Color& albedo, double fuzz, ofTexture* texture)
+Metal::Metal(const Color& albedo, double fuzz, std::shared_ptr<const CpuTexture> texture)
 {
     this->_albedo = albedo;
     this->_fuzz = (fuzz < 1.0) ? fuzz : 1.0;
     this->_texture = texture;
-
-    if (texture && texture->isAllocated()) {
-        texture->readToPixels(this->_cachedPixels);
-    }
 }
 
 bool Metal::scatter(
@@ -64,22 +58,8 @@ bool Metal::scatter(
     reflected = unitVector(reflected) + (this->_fuzz * randomUnitVector());
     scattered = Ray(rec.p, reflected);
 
-    if (this->_cachedPixels.isAllocated()) {
-        int x = static_cast<int>(rec.u * (this->_cachedPixels.getWidth() - 1));
-        int y = static_cast<int>(rec.v * (this->_cachedPixels.getHeight() - 1));
-        x = std::max(0, std::min(x, static_cast<int>(this->_cachedPixels.getWidth() - 1)));
-        y = std::max(0, std::min(y, static_cast<int>(this->_cachedPixels.getHeight() - 1)));
-
-        ofColor texColor = this->_cachedPixels.getColor(x, y);
-
-        attenuation = Color(
-            texColor.r / 255.0 * this->_albedo.x(),
-            texColor.g / 255.0 * this->_albedo.y(),
-            texColor.b / 255.0 * this->_albedo.z()
-        );
-    } else {
-        attenuation = this->_albedo;
-    }
+    if (this->_texture) attenuation = this->_texture->sampleFootprint(rec.u, rec.v, uvFootprint(rIn, rec)) * this->_albedo;
+    else attenuation = this->_albedo;
 
     return dot(scattered.direction(), rec.normal) > 0;
 }
@@ -116,7 +96,7 @@ bool Dielectric::scatter(
 
 double Dielectric::_randomDouble()
 {
-    return std::rand() / (RAND_MAX + 1.0);
+    return Random::uniform();
 }
 
 double Dielectric::_reflectance(double cosine, double refractionIndex)
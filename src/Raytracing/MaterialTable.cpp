@@ -0,0 +1,114 @@
+#include "MaterialTable.hpp"
+
+bool MaterialDesc::operator==(const MaterialDesc& other) const
+{
+    return this->kind == other.kind
+        && this->color.x() == other.color.x()
+        && this->color.y() == other.color.y()
+        && this->color.z() == other.color.z()
+        && this->parameter == other.parameter
+        && this->texture == other.texture;
+}
+
+size_t MaterialTable::DescHash::operator()(const MaterialDesc& desc) const
+{
+    size_t hash = std::hash<int>()(static_cast<int>(desc.kind));
+
+    auto mix = [&hash](size_t value) {
+        hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    };
+
+    mix(std::hash<double>()(desc.color.x()));
+    mix(std::hash<double>()(desc.color.y()));
+    mix(std::hash<double>()(desc.color.z()));
+    mix(std::hash<double>()(desc.parameter));
+    mix(std::hash<const void*>()(desc.texture.get()));
+
+    return hash;
+}
+
+uint32_t MaterialTable::acquire(const MaterialDesc& desc)
+{
+    auto found = this->_lookup.find(desc);
+
+    if (found != this->_lookup.end()) {
+        this->_slots[found->second].references++;
+        return found->second;
+    }
+
+    uint32_t index;
+
+    if (!this->_freeSlots.empty()) {
+        index = this->_freeSlots.back();
+        this->_freeSlots.pop_back();
+    } else {
+        index = static_cast<uint32_t>(this->_slots.size());
+        this->_slots.emplace_back();
+    }
+
+    Slot& slot = this->_slots[index];
+    slot.material = _create(desc);
+    slot.desc = desc;
+    slot.references = 1;
+    this->_lookup[desc] = index;
+
+    return index;
+}
+
+void MaterialTable::release(uint32_t index)
+{
+    if (index >= this->_slots.size() || this->_slots[index].references == 0) return;
+
+    Slot& slot = this->_slots[index];
+
+    if (--slot.references > 0) return;
+
+    this->_lookup.erase(slot.desc);
+    slot.material.reset();
+    this->_freeSlots.push_back(index);
+}
+
+void MaterialTable::clear()
+{
+    this->_slots.clear();
+    this->_freeSlots.clear();
+    this->_lookup.clear();
+}
+
+const Materials& MaterialTable::get(uint32_t index) const
+{
+    if (index < this->_slots.size() && this->_slots[index].material)
+        return *this->_slots[index].material;
+
+    return fallback();
+}
+
+MaterialKind MaterialTable::kind(uint32_t index) const
+{
+    if (index < this->_slots.size() && this->_slots[index].material)
+        return this->_slots[index].desc.kind;
+
+    return MaterialKind::Lambertian;
+}
+
+size_t MaterialTable::size() const
+{
+    return this->_lookup.size();
+}
+
+std::shared_ptr<const Materials> MaterialTable::_create(const MaterialDesc& desc)
+{
+    switch (desc.kind) {
+        case MaterialKind::Metal: return std::make_shared<Metal>(desc.color, desc.parameter, desc.texture);
+        case MaterialKind::Dielectric: return std::make_shared<Dielectric>(desc.parameter);
+        case MaterialKind::DiffuseLight: return std::make_shared<DiffuseLight>(desc.color);
+        case MaterialKind::Lambertian:
+        default: return std::make_shared<Lambertian>(desc.color, desc.texture);
+    }
+}
+
+const Materials& MaterialTable::fallback()
+{
+    static const Lambertian fallback(Color(0.5, 0.5, 0.5));
+    return fallback;
+}
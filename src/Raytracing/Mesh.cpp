@@ -1,28 +1,87 @@
 #include "Mesh.hpp"
 
-Mesh::Mesh(std::shared_ptr<Materials> mat)
+Mesh::Mesh(uint32_t material)
 {
-    this->_mat = mat;
+    this->_material = material;
     this->_bvhBuilt = false;
 }
 
+void Mesh::reserve(size_t vertexCount, size_t triangleCount)
+{
+    this->_positions.reserve(vertexCount * 3);
+    this->_indices.reserve(triangleCount * 3);
+}
+
+uint32_t Mesh::addVertex(const point3& position)
+{
+    uint32_t index = static_cast<uint32_t>(this->_positions.size() / 3);
+
+    this->_positions.push_back(static_cast<float>(position.x()));
+    this->_positions.push_back(static_cast<float>(position.y()));
+    this->_positions.push_back(static_cast<float>(position.z()));
+
+    return index;
+}
+
+void Mesh::setVertexNormal(uint32_t vertex, const Vec3& normal)
+{
+    if (this->_normals.size() < this->_positions.size())
+        this->_normals.resize(this->_positions.size(), 0.0f);
+
+    this->_normals[vertex * 3 + 0] = static_cast<float>(normal.x());
+    this->_normals[vertex * 3 + 1] = static_cast<float>(normal.y());
+    this->_normals[vertex * 3 + 2] = static_cast<float>(normal.z());
+}
+
+void Mesh::setVertexUV(uint32_t vertex, double u, double v)
+{
+    if (this->_uvs.size() < this->_positions.size() / 3 * 2)
+        this->_uvs.resize(this->_positions.size() / 3 * 2, 0.0f);
+
+    this->_uvs[vertex * 2 + 0] = static_cast<float>(u);
+    this->_uvs[vertex * 2 + 1] = static_cast<float>(v);
+}
+
+void Mesh::addTriangle(uint32_t i0, uint32_t i1, uint32_t i2)
+{
+    this->_indices.push_back(i0);
+    this->_indices.push_back(i1);
+    this->_indices.push_back(i2);
+}
+
 void Mesh::addTriangle(const point3& v0, const point3& v1, const point3& v2)
 {
-    this->_triangles.push_back(std::make_shared<Triangles>(v0, v1, v2, this->_mat));
+    uint32_t i0 = this->addVertex(v0);
+    uint32_t i1 = this->addVertex(v1);
+    uint32_t i2 = this->addVertex(v2);
+
+    this->addTriangle(i0, i1, i2);
 }
 
-void Mesh::buildBVH()
+void Mesh::buildBVH(ThreadPool* threadPool)
 {
-    if (this->_triangles.empty()) return;
+    size_t count = this->triangleCount();
+
+    if (count == 0) return;
+
+    std::vector<Aabb> bounds;
+    bounds.reserve(count);
 
-    this->_bbox = this->_triangles[0]->boundingBox();
-    for (size_t i = 1; i < this->_triangles.size(); i++)
-        this->_bbox = Aabb::surroundingBox(this->_bbox, this->_triangles[i]->boundingBox());
+    for (size_t tri = 0; tri < count; tri++) {
+        point3 p0 = this->_position(this->_indices[tri * 3 + 0]);
+        point3 p1 = this->_position(this->_indices[tri * 3 + 1]);
+        point3 p2 = this->_position(this->_indices[tri * 3 + 2]);
 
-    HittableList triangleList;
-    for (auto& tri : this->_triangles) triangleList.add(tri);
+        bounds.emplace_back(
+            point3(std::fmin(p0.x(), std::fmin(p1.x(), p2.x())), std::fmin(p0.y(), std::fmin(p1.y(), p2.y())), std::fmin(p0.z(), std::fmin(p1.z(), p2.z()))),
+            point3(std::fmax(p0.x(), std::fmax(p1.x(), p2.x())), std::fmax(p0.y(), std::fmax(p1.y(), p2.y())), std::fmax(p0.z(), std::fmax(p1.z(), p2.z())))
+        );
 
-    this->_bvhRoot = std::make_shared<Bvh>(triangleList);
+        this->_bbox = (tri == 0) ? bounds.back() : Aabb::surroundingBox(this->_bbox, bounds.back());
+    }
+
+    this->_bvh.build(bounds, threadPool);
+    this->_packTriangles();
     this->_bvhBuilt = true;
 }
 
@@ -30,7 +89,29 @@ bool Mesh::hit(const Ray& r, Interval rayT, HitRecord& rec) const
 {
     if (!this->_bvhBuilt) return false;
 
-    return this->_bvhRoot->hit(r, rayT, rec);
+    return this->_bvh.intersect(r, rayT, rec, [this, &r](uint32_t firstSlot, uint32_t count, const SimdRay& ray, Interval t, HitRecord& record) {
+        return this->_hitLeaf(firstSlot, count, ray, r, t, record);
+    });
+}
+
+bool Mesh::occluded(const Ray& r, Interval rayT) const
+{
+    if (!this->_bvhBuilt) return false;
+
+    int width = this->_bvh.width();
+
+    return this->_bvh.occluded(r, rayT, [this, width](uint32_t firstSlot, uint32_t count, const SimdRay& ray, const Interval& t) {
+        float tMax = static_cast<float>(t.max);
+
+        for (uint32_t slot = firstSlot; slot < firstSlot + count; slot += width) {
+            float tHit, u, v;
+
+            if (Simd::intersectTriangles(width, &this->_triangleBlocks[slot * 9], ray, tMax, tHit, u, v) >= 0 && t.surrounds(tHit))
+                return true;
+        }
+
+        return false;
+    });
 }
 
 Aabb Mesh::boundingBox() const
@@ -38,7 +119,152 @@ Aabb Mesh::boundingBox() const
     return this->_bbox;
 }
 
+PrimitiveKind Mesh::primitiveKind() const
+{
+    return PrimitiveKind::Mesh;
+}
+
 size_t Mesh::triangleCount() const
 {
-    return this->_triangles.size();
+    return this->_indices.size() / 3;
+}
+
+size_t Mesh::vertexCount() const
+{
+    return this->_positions.size() / 3;
 }
+
+size_t Mesh::memoryUsage() const
+{
+    return (this->_positions.size() + this->_normals.size() + this->_uvs.size()) * sizeof(float)
+        + this->_indices.size() * sizeof(uint32_t)
+        + this->_triangleBlocks.size() * sizeof(float)
+        + this->_blockTriangles.size() * sizeof(uint32_t)
+        + this->_bvh.nodeMemory()
+        + this->_bvh.primitiveSlots().size() * sizeof(uint32_t);
+}
+
+size_t Mesh::bvhNodeMemory() const
+{
+    return this->_bvh.nodeMemory();
+}
+
+const LinearBvh::BuildStats& Mesh::bvhStats() const
+{
+    return this->_bvh.buildStats();
+}
+
+point3 Mesh::_position(uint32_t vertex) const
+{
+    const float* p = &this->_positions[vertex * 3];
+    return point3(p[0], p[1], p[2]);
+}
+
+// Lays out every leaf slot of the BVH as one lane of a v0 / edge1 / edge2 block. Padding
+// lanes get zero edges, which the kernel rejects as degenerate.
+void Mesh::_packTriangles()
+{
+    const std::vector<uint32_t>& slots = this->_bvh.primitiveSlots();
+    int width = this->_bvh.width();
+
+    this->_blockTriangles = slots;
+    this->_triangleBlocks.assign(slots.size() * 9, 0.0f);
+
+    for (size_t slot = 0; slot < slots.size(); slot++) {
+        uint32_t triangle = slots[slot];
+
+        if (triangle == WideBvh::invalidPrimitive) continue;
+
+        const float* p0 = &this->_positions[this->_indices[triangle * 3 + 0] * 3];
+        const float* p1 = &this->_positions[this->_indices[triangle * 3 + 1] * 3];
+        const float* p2 = &this->_positions[this->_indices[triangle * 3 + 2] * 3];
+        float* block = &this->_triangleBlocks[(slot / width) * 9 * width];
+        size_t lane = slot % width;
+
+        for (int axis = 0; axis < 3; axis++) {
+            block[(0 + axis) * width + lane] = p0[axis];
+            block[(3 + axis) * width + lane] = p1[axis] - p0[axis];
+            block[(6 + axis) * width + lane] = p2[axis] - p0[axis];
+        }
+    }
+}
+
+bool Mesh::_hitLeaf(uint32_t firstSlot, uint32_t count, const SimdRay& ray, const Ray& r, const Interval& rayT, HitRecord& rec) const
+{
+    int width = this->_bvh.width();
+    uint32_t lastSlot = firstSlot + count;
+    uint32_t bestSlot = WideBvh::invalidPrimitive;
+    float tMax = static_cast<float>(rayT.max);
+    float bestU = 0.0f;
+    float bestV = 0.0f;
+
+    for (uint32_t slot = firstSlot; slot < lastSlot; slot += width) {
+        float t, u, v;
+        int lane = Simd::intersectTriangles(width, &this->_triangleBlocks[slot * 9], ray, tMax, t, u, v);
+
+        if (lane < 0) continue;
+
+        bestSlot = slot + lane;
+        tMax = t;
+        bestU = u;
+        bestV = v;
+    }
+
+    if (bestSlot == WideBvh::invalidPrimitive || !rayT.surrounds(tMax))
+        return false;
+
+    uint32_t triangle = this->_blockTriangles[bestSlot];
+    const uint32_t* vertex = &this->_indices[triangle * 3];
+    double u = bestU;
+    double v = bestV;
+    double w = 1.0 - u - v;
+    point3 p0 = this->_position(vertex[0]);
+    Vec3 geometricNormal = cross(this->_position(vertex[1]) - p0, this->_position(vertex[2]) - p0);
+
+    rec.t = tMax;
+    rec.p = r.at(rec.t);
+    rec.material = this->_material;
+
+    // Which side was hit comes from the triangle itself; the interpolated normal is only
+    // used for shading, flipped into the same hemisphere as the facing geometric one.
+    rec.setFaceNormal(r, unitVector(geometricNormal));
+
+    if (!this->_normals.empty()) {
+        const float* n0 = &this->_normals[vertex[0] * 3];
+        const float* n1 = &this->_normals[vertex[1] * 3];
+        const float* n2 = &this->_normals[vertex[2] * 3];
+
+        Vec3 shadingNormal(
+            w * n0[0] + u * n1[0] + v * n2[0],
+            w * n0[1] + u * n1[1] + v * n2[1],
+            w * n0[2] + u * n1[2] + v * n2[2]
+        );
+
+        if (shadingNormal.lengthSquared() > 1e-12) {
+            shadingNormal = unitVector(shadingNormal);
+            rec.normal = dot(shadingNormal, rec.normal) < 0 ? -shadingNormal : shadingNormal;
+        }
+    }
+
+    // Without UVs the barycentrics are the UVs, spanning half the unit square.
+    double uvArea = 1.0;
+
+    if (!this->_uvs.empty()) {
+        const float* uv0 = &this->_uvs[vertex[0] * 2];
+        const float* uv1 = &this->_uvs[vertex[1] * 2];
+        const float* uv2 = &this->_uvs[vertex[2] * 2];
+
+        rec.u = w * uv0[0] + u * uv1[0] + v * uv2[0];
+        rec.v = w * uv0[1] + u * uv1[1] + v * uv2[1];
+        uvArea = std::fabs((uv1[0] - uv0[0]) * (uv2[1] - uv0[1]) - (uv2[0] - uv0[0]) * (uv1[1] - uv0[1]));
+    } else {
+        rec.u = u;
+        rec.v = v;
+    }
+
+    // Both areas are doubled, so their ratio is the triangle's UV to world area ratio.
+    double worldArea = geometricNormal.length();
+    rec.uvDensity = worldArea > 0.0 ? std::sqrt(uvArea / worldArea) : 0.0;
+
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "OrientedBox.hpp"
+
+OrientedBox::OrientedBox(const glm::mat4& objectToWorld, const Vec3& halfExtents, uint32_t material)
+    : _objectToWorld(objectToWorld), _worldToObject(glm::inverse(objectToWorld))
+{
+    this->_halfExtents = Vec3(
+        std::fabs(halfExtents.x()), std::fabs(halfExtents.y()), std::fabs(halfExtents.z())
+    );
+    this->_material = material;
+
+    for (int axis = 0; axis < 3; axis++) {
+        Vec3 edgeU(0, 0, 0);
+        Vec3 edgeV(0, 0, 0);
+        edgeU[(axis + 1) % 3] = 2.0 * this->_halfExtents[(axis + 1) % 3];
+        edgeV[(axis + 2) % 3] = 2.0 * this->_halfExtents[(axis + 2) % 3];
+
+        double area = cross(this->_objectToWorld.vector(edgeU), this->_objectToWorld.vector(edgeV)).length();
+        this->_uvDensity[axis] = area > 0.0 ? 1.0 / std::sqrt(area) : 0.0;
+    }
+
+    this->_bbox = this->_objectToWorld.bounds(Aabb(-this->_halfExtents, this->_halfExtents));
+}
+
+bool OrientedBox::_slabs(const Ray& r, double& tNear, double& tFar, int& nearAxis, int& farAxis) const
+{
+    tNear = -INFINITY;
+    tFar = INFINITY;
+    nearAxis = 0;
+    farAxis = 0;
+
+    for (int axis = 0; axis < 3; axis++) {
+        double origin = r.origin()[axis];
+        double direction = r.direction()[axis];
+        double extent = this->_halfExtents[axis];
+
+        if (direction == 0.0) {
+            if (origin < -extent || origin > extent) return false;
+            continue;
+        }
+
+        double inverse = 1.0 / direction;
+        double t0 = (-extent - origin) * inverse;
+        double t1 = (extent - origin) * inverse;
+        if (t0 > t1) std::swap(t0, t1);
+
+        if (t0 > tNear) { tNear = t0; nearAxis = axis; }
+        if (t1 < tFar) { tFar = t1; farAxis = axis; }
+        if (tNear > tFar) return false;
+    }
+
+    return true;
+}
+
+bool OrientedBox::hit(const Ray& r, Interval rayT, HitRecord& rec) const
+{
+    // Like Instance, the direction is not renormalised so t is shared by both spaces.
+    Ray objectRay(this->_worldToObject.point(r.origin()), this->_worldToObject.vector(r.direction()));
+
+    double tNear, tFar;
+    int nearAxis, farAxis;
+    if (!this->_slabs(objectRay, tNear, tFar, nearAxis, farAxis)) return false;
+
+    double t = tNear;
+    int axis = nearAxis;
+    if (!rayT.surrounds(t)) {
+        t = tFar;
+        axis = farAxis;
+        if (!rayT.surrounds(t)) return false;
+    }
+
+    point3 local = objectRay.at(t);
+    double side = local[axis] < 0.0 ? -1.0 : 1.0;
+
+    Vec3 localNormal(0, 0, 0);
+    localNormal[axis] = side;
+
+    rec.t = t;
+    rec.p = r.at(t);
+    rec.setFaceNormal(r, unitVector(this->_worldToObject.normal(localNormal)));
+    rec.material = this->_material;
+    rec.uvDensity = this->_uvDensity[axis];
+
+    // Same layout as the generated box mesh: faces map [-half, half] to [0, 1].
+    double x = 0.5 * local.x() / this->_halfExtents.x();
+    double y = 0.5 * local.y() / this->_halfExtents.y();
+    double z = 0.5 * local.z() / this->_halfExtents.z();
+
+    if (axis == 0) {
+        rec.u = side > 0 ? 0.5 - z : z + 0.5;
+        rec.v = 0.5 - y;
+    } else if (axis == 1) {
+        rec.u = x + 0.5;
+        rec.v = side > 0 ? z + 0.5 : 0.5 - z;
+    } else {
+        rec.u = side > 0 ? x + 0.5 : 0.5 - x;
+        rec.v = 0.5 - y;
+    }
+
+    return true;
+}
+
+bool OrientedBox::occluded(const Ray& r, Interval rayT) const
+{
+    Ray objectRay(this->_worldToObject.point(r.origin()), this->_worldToObject.vector(r.direction()));
+
+    double tNear, tFar;
+    int nearAxis, farAxis;
+    if (!this->_slabs(objectRay, tNear, tFar, nearAxis, farAxis)) return false;
+
+    return rayT.surrounds(tNear) || rayT.surrounds(tFar);
+}
+
+Aabb OrientedBox::boundingBox() const
+{
+    return this->_bbox;
+}
+
+PrimitiveKind OrientedBox::primitiveKind() const
+{
+    return PrimitiveKind::Box;
+}
@@ -0,0 +1,41 @@
+#include "PrimitiveRef.hpp"
+
+#include "Mesh.hpp"
+#include "Spheres.hpp"
+#include "SphereSet.hpp"
+#include "OrientedBox.hpp"
+#include "FinitePlane.hpp"
+#include "Instance.hpp"
+
+PrimitiveRef::PrimitiveRef(const Hittable* object)
+    : object(object), kind(object ? object->primitiveKind() : PrimitiveKind::Other) {}
+
+// The classes are final, so the qualified calls below are exactly what virtual dispatch
+// would have picked.
+bool PrimitiveRef::hit(const Ray& r, Interval rayT, HitRecord& rec) const
+{
+    switch (this->kind) {
+        case PrimitiveKind::Mesh: return static_cast<const Mesh*>(this->object)->Mesh::hit(r, rayT, rec);
+        case PrimitiveKind::Sphere: return static_cast<const Spheres*>(this->object)->Spheres::hit(r, rayT, rec);
+        case PrimitiveKind::SphereSet: return static_cast<const SphereSet*>(this->object)->SphereSet::hit(r, rayT, rec);
+        case PrimitiveKind::Box: return static_cast<const OrientedBox*>(this->object)->OrientedBox::hit(r, rayT, rec);
+        case PrimitiveKind::Plane: return static_cast<const FinitePlane*>(this->object)->FinitePlane::hit(r, rayT, rec);
+        case PrimitiveKind::Instance: return static_cast<const Instance*>(this->object)->Instance::hit(r, rayT, rec);
+        case PrimitiveKind::Other:
+        default: return this->object->hit(r, rayT, rec);
+    }
+}
+
+bool PrimitiveRef::occluded(const Ray& r, Interval rayT) const
+{
+    switch (this->kind) {
+        case PrimitiveKind::Mesh: return static_cast<const Mesh*>(this->object)->Mesh::occluded(r, rayT);
+        case PrimitiveKind::Sphere: return static_cast<const Spheres*>(this->object)->Spheres::occluded(r, rayT);
+        case PrimitiveKind::SphereSet: return static_cast<const SphereSet*>(this->object)->SphereSet::occluded(r, rayT);
+        case PrimitiveKind::Box: return static_cast<const OrientedBox*>(this->object)->OrientedBox::occluded(r, rayT);
+        case PrimitiveKind::Plane: return static_cast<const FinitePlane*>(this->object)->FinitePlane::occluded(r, rayT);
+        case PrimitiveKind::Instance: return static_cast<const Instance*>(this->object)->Instance::occluded(r, rayT);
+        case PrimitiveKind::Other:
+        default: return this->object->occluded(r, rayT);
+    }
+}
@@ -0,0 +1,18 @@
+#include "Random.hpp"
+
+thread_local Pcg32 Random::_engine;
+
+void Random::seed(uint64_t seed)
+{
+    _engine.seed(seed);
+}
+
+double Random::uniform()
+{
+    return _engine.nextDouble();
+}
+
+double Random::uniform(double min, double max)
+{
+    return min + (max - min) * uniform();
+}
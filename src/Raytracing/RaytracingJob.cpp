@@ -0,0 +1,212 @@
+#include "RaytracingJob.hpp"
+
+RaytracingJob::~RaytracingJob()
+{
+    this->cancel();
+}
+
+void RaytracingJob::start(const CameraWithLights& camera, const sceneLights& lights, const RaytracingScene::Snapshot& scene, int maxSamples, const Denoiser* denoiser)
+{
+    this->cancel();
+
+    this->_camera = camera;
+    this->_lights = lights;
+    this->_scene = scene;
+    this->_maxSamples = maxSamples;
+
+    this->_camera.lights = &this->_lights;
+    this->_camera.materials = this->_scene.materials.get();
+
+    this->_tiles = this->_camera.prepareTiles();
+    this->_accumulation.assign(static_cast<size_t>(this->_camera.imageWidth) * this->_camera.imageHeight() * 3, 0.0f);
+
+    if (this->_camera.adaptiveSampling) this->_stats.reset(this->_accumulation.size() / 3);
+    else this->_stats = CameraWithLights::PixelStats();
+
+    this->_denoise = denoiser && !(camera.adaptiveSampling && camera.sampleHeatMap);
+    if (this->_denoise) {
+        this->_denoiser = *denoiser;
+        this->_aovs.reset(this->_accumulation.size() / 3);
+        this->_frame.resize(this->_camera.imageWidth, this->_camera.imageHeight());
+    } else {
+        this->_aovs = CameraWithLights::AovBuffers();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->_updateMutex);
+        this->_latestUpdates.assign(this->_tiles.size(), TileUpdate());
+        this->_pending.assign(this->_tiles.size(), 0);
+        this->_pendingTiles.clear();
+    }
+
+    this->_cancelled = false;
+    this->_sampleCount = 0;
+    this->_rayCount = 0;
+    this->_pathCount = 0;
+    this->_activeNanoseconds = 0;
+    this->_activePixels = this->_accumulation.size() / 3;
+    this->_startTime = std::chrono::steady_clock::now();
+    this->_running = true;
+    this->_thread = std::thread(&RaytracingJob::_run, this);
+}
+
+void RaytracingJob::cancel()
+{
+    this->_cancelled = true;
+
+    if (this->_thread.joinable()) this->_thread.join();
+
+    this->_running = false;
+}
+
+bool RaytracingJob::running() const
+{
+    return this->_running;
+}
+
+int RaytracingJob::sampleCount() const
+{
+    return this->_sampleCount;
+}
+
+double RaytracingJob::raysPerSecond() const
+{
+    int64_t nanoseconds = this->_activeNanoseconds;
+    return nanoseconds > 0 ? this->_rayCount * 1e9 / nanoseconds : 0.0;
+}
+
+double RaytracingJob::convergedFraction() const
+{
+    size_t pixelCount = this->_accumulation.size() / 3;
+    return pixelCount > 0 ? 1.0 - static_cast<double>(this->_activePixels) / pixelCount : 0.0;
+}
+
+double RaytracingJob::raysPerPath() const
+{
+    uint64_t paths = this->_pathCount;
+    return paths > 0 ? static_cast<double>(this->_rayCount) / paths : 0.0;
+}
+
+void RaytracingJob::takeTileUpdates(std::vector<TileUpdate>& updates)
+{
+    updates.clear();
+
+    std::lock_guard<std::mutex> lock(this->_updateMutex);
+
+    for (uint32_t tileIndex : this->_pendingTiles) {
+        updates.push_back(std::move(this->_latestUpdates[tileIndex]));
+        this->_pending[tileIndex] = 0;
+    }
+
+    this->_pendingTiles.clear();
+}
+
+// Renders passes of samplesPerPixel samples over every tile. Tiles are dispatched in
+// small batches so the shared pool is never held for a whole pass: scene rebuilds on the
+// main thread only wait for the batch in flight. In adaptive mode converged pixels are
+// skipped, and the trace ends early once a pass finds none left to sample.
+void RaytracingJob::_run()
+{
+    ThreadPool* pool = this->_camera.threadPool;
+    size_t batchSize = pool ? std::max<size_t>(1, pool->size() * 2) : 1;
+    int samplesPerPass = std::max(1, this->_camera.samplesPerPixel);
+    CameraWithLights::PixelStats* stats = this->_camera.adaptiveSampling ? &this->_stats : nullptr;
+
+    while (!this->_cancelled && this->_sampleCount < this->_maxSamples) {
+        int sampleOffset = this->_sampleCount;
+        std::atomic<uint64_t> pixelsSampled{0};
+
+        auto renderTile = [&](size_t tileIndex) {
+            const CameraWithLights::Tile& tile = this->_tiles[tileIndex];
+            CameraWithLights::TileContext context;
+            context.cancelled = &this->_cancelled;
+            context.stats = stats;
+            context.aovs = this->_denoise ? &this->_aovs : nullptr;
+
+            bool finished = this->_camera.renderTile(tile, *this->_scene.world, this->_accumulation, sampleOffset, &context);
+
+            this->_rayCount += context.rays;
+            if (!finished || context.pixelsSampled == 0) return;
+
+            this->_pathCount += context.pixelsSampled * samplesPerPass;
+            pixelsSampled += context.pixelsSampled;
+
+            if (this->_denoise) return;
+
+            std::vector<unsigned char> pixels;
+            // Converged tiles are not resolved again, so the heat map is scaled to the cap.
+            int resolveCount = stats && this->_camera.sampleHeatMap ? this->_maxSamples : sampleOffset + samplesPerPass;
+            this->_camera.resolveTile(tile, this->_accumulation, resolveCount, pixels, stats);
+            this->_publish(static_cast<uint32_t>(tileIndex), pixels);
+        };
+
+        for (size_t begin = 0; begin < this->_tiles.size() && !this->_cancelled; begin += batchSize) {
+            size_t count = std::min(batchSize, this->_tiles.size() - begin);
+
+            if (pool) pool->parallelFor(count, [&](size_t index, size_t) { renderTile(begin + index); });
+            else renderTile(begin);
+
+            this->_activeNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->_startTime).count();
+        }
+
+        if (this->_cancelled) break;
+
+        this->_activePixels = pixelsSampled.load();
+        if (this->_activePixels == 0) break;
+
+        this->_sampleCount += samplesPerPass;
+
+        if (this->_denoise) {
+            this->_denoisePass(this->_sampleCount);
+            this->_activeNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->_startTime).count();
+        }
+    }
+
+    this->_running = false;
+}
+
+// Turns the sums into per-pixel means, filters them and publishes every tile.
+void RaytracingJob::_denoisePass(int sampleCount)
+{
+    size_t pixelCount = this->_accumulation.size() / 3;
+    bool adaptive = !this->_stats.sampleCounts.empty();
+
+    for (size_t pixel = 0; pixel < pixelCount; pixel++) {
+        uint32_t count = adaptive ? this->_stats.sampleCounts[pixel] : static_cast<uint32_t>(sampleCount);
+        float scale = 1.0f / std::max<uint32_t>(1, count);
+
+        for (size_t c = pixel * 3; c < pixel * 3 + 3; c++) {
+            this->_frame.color[c] = this->_accumulation[c] * scale;
+            this->_frame.albedo[c] = this->_aovs.albedo[c] * scale;
+            this->_frame.normal[c] = this->_aovs.normal[c] * scale;
+        }
+        this->_frame.depth[pixel] = this->_aovs.depth[pixel] * scale;
+    }
+
+    this->_denoiser.denoise(this->_frame, this->_denoised, this->_camera.threadPool);
+
+    for (size_t tileIndex = 0; tileIndex < this->_tiles.size() && !this->_cancelled; tileIndex++) {
+        std::vector<unsigned char> pixels;
+        this->_camera.resolveTile(this->_tiles[tileIndex], this->_denoised, 1, pixels);
+        this->_publish(static_cast<uint32_t>(tileIndex), pixels);
+    }
+}
+
+void RaytracingJob::_publish(uint32_t tileIndex, std::vector<unsigned char>& pixels)
+{
+    const CameraWithLights::Tile& tile = this->_tiles[tileIndex];
+
+    std::lock_guard<std::mutex> lock(this->_updateMutex);
+
+    TileUpdate& update = this->_latestUpdates[tileIndex];
+    update.x = tile.x0;
+    update.y = this->_camera.imageHeight() - tile.y1;
+    update.width = tile.x1 - tile.x0;
+    update.height = tile.y1 - tile.y0;
+    update.pixels.swap(pixels);
+
+    if (!this->_pending[tileIndex]) {
+        this->_pending[tileIndex] = 1;
+        this->_pendingTiles.push_back(tileIndex);
+    }
+}
@@ -0,0 +1,97 @@
+#include "RaytracingQuality.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+bool RaytracingQuality::Settings::operator==(const Settings& other) const
+{
+    return this->width == other.width
+        && this->height == other.height
+        && this->samplesPerPixel == other.samplesPerPixel
+        && this->maxDepth == other.maxDepth;
+}
+
+bool RaytracingQuality::Settings::operator!=(const Settings& other) const
+{
+    return !(*this == other);
+}
+
+RaytracingQuality::Settings RaytracingQuality::update(bool moving, int viewportWidth, int viewportHeight, double raysPerSecond, double raysPerPath)
+{
+    Clock::time_point now = Clock::now();
+
+    if (moving) this->_lastMotion = now;
+
+    // Smooth the throughput so one short or cancelled pass does not swing the resolution.
+    if (raysPerSecond > 0.0)
+        this->_raysPerSecond = this->_raysPerSecond > 0.0 ? 0.7 * this->_raysPerSecond + 0.3 * raysPerSecond : raysPerSecond;
+    if (raysPerPath > 0.0)
+        this->_raysPerPath = raysPerPath;
+
+    viewportWidth = std::max(1, viewportWidth);
+    viewportHeight = std::max(1, viewportHeight);
+
+    double aspect = static_cast<double>(viewportWidth) / viewportHeight;
+    double fullWidth = std::min(viewportWidth, this->maxWidth);
+    double fullPixels = fullWidth * (fullWidth / aspect);
+    double budgetRays = this->_raysPerSecond * this->targetFrameMilliseconds * 1e-3;
+    double pathRays = this->_raysPerPath > 0.0 ? this->_raysPerPath : 1.0;
+
+    bool wasSettled = this->_settled;
+    bool resized = viewportWidth != this->_viewportWidth || viewportHeight != this->_viewportHeight;
+
+    this->_settled = std::chrono::duration<double>(now - this->_lastMotion).count() >= this->settleSeconds;
+    this->_viewportWidth = viewportWidth;
+    this->_viewportHeight = viewportHeight;
+
+    // Settled settings are frozen so the converging image is never restarted.
+    if (this->_settled && wasSettled && !resized) return this->_settings;
+
+    Settings settings;
+
+    if (this->_settled) {
+        this->_scale = 1.0;
+        settings.maxDepth = this->fullDepth;
+
+        // Keep each pass near the budget so the first full-resolution tiles show up quickly.
+        double samples = budgetRays > 0.0 ? budgetRays / (fullPixels * pathRays) : 1.0;
+        settings.samplesPerPixel = std::clamp(static_cast<int>(samples), 1, this->fullSamplesPerPixel);
+    } else {
+        settings.maxDepth = this->interactiveDepth;
+        settings.samplesPerPixel = 1;
+
+        if (moving && budgetRays > 0.0) {
+            double target = std::sqrt(budgetRays / (fullPixels * pathRays));
+            target = std::clamp(target, this->minScale, 1.0);
+
+            // Only follow changes above 10% to avoid restarting on measurement noise.
+            if (std::fabs(target - this->_scale) > 0.1 * this->_scale) this->_scale = target;
+        }
+    }
+
+    settings.width = std::max(16, _roundToTile(fullWidth * this->_scale));
+    settings.height = std::max(1, static_cast<int>(settings.width / aspect));
+
+    this->_settings = settings;
+    return settings;
+}
+
+bool RaytracingQuality::settled() const
+{
+    return this->_settled;
+}
+
+double RaytracingQuality::scale() const
+{
+    return this->_scale;
+}
+
+double RaytracingQuality::raysPerSecond() const
+{
+    return this->_raysPerSecond;
+}
+
+int RaytracingQuality::_roundToTile(double value)
+{
+    return static_cast<int>(std::lround(value / 16.0)) * 16;
+}
@@ -0,0 +1,650 @@
+#include "RaytracingScene.hpp"
+
+RaytracingScene::RaytracingScene(ComponentRegistry& registry, EntityManager& entityManager)
+    : _registry(registry), _entityManager(entityManager) {}
+
+bool RaytracingScene::update()
+{
+    bool changed = false;
+    bool restructured = false;
+    std::vector<const Record*> moved;
+    this->_pendingStats = Stats();
+
+    this->_finishRebuild();
+
+    for (auto& [id, record] : this->_records)
+        record.alive = false;
+
+    for (EntityID id : this->_entityManager.getAllEntities()) {
+        Transform* transform = this->_registry.getComponent<Transform>(id);
+        Renderable* render = this->_registry.getComponent<Renderable>(id);
+
+        if (!transform || !render || !render->visible) continue;
+
+        Record& record = this->_records[id];
+        record.alive = true;
+
+        bool wasSphere = record.isSphere;
+        bool hadGeometry = record.geometry != nullptr;
+
+        if (!this->_updateRecord(id, record, *transform, *render)) continue;
+
+        changed = true;
+
+        // A placed record that keeps its kind only needs its slot refitted.
+        if (record.slot == invalidSlot || record.isSphere != wasSphere || (record.geometry != nullptr) != hadGeometry)
+            restructured = true;
+        else
+            moved.push_back(&record);
+    }
+
+    for (auto it = this->_records.begin(); it != this->_records.end();) {
+        if (!it->second.alive) {
+            this->_materials.release(it->second.material);
+            it = this->_records.erase(it);
+            changed = true;
+            restructured = true;
+        } else {
+            ++it;
+        }
+    }
+
+    if (changed) {
+        if (restructured || !this->_refitTopLevel(moved))
+            this->_rebuildTopLevel();
+
+        // Drop bottom-level meshes that no record references any more.
+        for (auto it = this->_meshCache.begin(); it != this->_meshCache.end();) {
+            if (it->second.use_count() == 1) it = this->_meshCache.erase(it);
+            else ++it;
+        }
+
+        this->_stats = this->_pendingStats;
+        this->_stats.cachedMeshCount = this->_meshCache.size();
+        this->_stats.materialCount = this->_materials.size();
+        this->_materialSnapshot.reset();
+
+        TextureCache::instance().purgeUnused();
+        this->_stats.textureMemoryBytes = TextureCache::instance().memoryUsage();
+        this->_generation++;
+    }
+
+    return changed;
+}
+
+void RaytracingScene::clear()
+{
+    this->_cancelRebuild();
+    this->_records.clear();
+    this->_meshCache.clear();
+    this->_materials.clear();
+    this->_materialSnapshot.reset();
+    this->_bvh.reset();
+    this->_sphereSet.reset();
+    this->_sphereObject = invalidSlot;
+    this->_sphereSetShared = false;
+    this->_generation++;
+}
+
+const Hittable& RaytracingScene::world() const
+{
+    static const HittableList emptyWorld;
+
+    if (this->_bvh) return *this->_bvh;
+    return emptyWorld;
+}
+
+const MaterialTable& RaytracingScene::materials() const
+{
+    return this->_materials;
+}
+
+RaytracingScene::Snapshot RaytracingScene::snapshot()
+{
+    static const std::shared_ptr<const Hittable> emptyWorld = std::make_shared<HittableList>();
+
+    if (!this->_materialSnapshot)
+        this->_materialSnapshot = std::make_shared<MaterialTable>(this->_materials);
+
+    Snapshot snapshot;
+    snapshot.world = this->_bvh ? std::shared_ptr<const Hittable>(this->_bvh) : emptyWorld;
+    snapshot.materials = this->_materialSnapshot;
+
+    return snapshot;
+}
+
+bool RaytracingScene::empty() const
+{
+    return !this->_bvh;
+}
+
+size_t RaytracingScene::recordCount() const
+{
+    return this->_records.size();
+}
+
+uint64_t RaytracingScene::generation() const
+{
+    return this->_generation;
+}
+
+const RaytracingScene::Stats& RaytracingScene::stats() const
+{
+    return this->_stats;
+}
+
+void RaytracingScene::setThreadPool(ThreadPool* threadPool)
+{
+    this->_threadPool = threadPool;
+}
+
+void RaytracingScene::hashBytes(uint64_t& hash, const void* data, size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+}
+
+bool RaytracingScene::_updateRecord(EntityID id, Record& record, const Transform& transform, const Renderable& render)
+{
+    Sphere* sphere = this->_registry.getComponent<Sphere>(id);
+    Box* box = nullptr;
+    Plane* plane = nullptr;
+
+    // Displacement rewrites a primitive's mesh, so only untouched ones can use the analytic shapes.
+    if (!sphere && render.isPrimitive && !this->_registry.getComponent<DisplacementMap>(id)) {
+        box = this->_registry.getComponent<Box>(id);
+        if (box && (box->dimensions.x <= 0 || box->dimensions.y <= 0 || box->dimensions.z <= 0)) box = nullptr;
+
+        plane = box ? nullptr : this->_registry.getComponent<Plane>(id);
+        if (plane && (plane->size.x <= 0 || plane->size.y <= 0)) plane = nullptr;
+    }
+
+    bool analytic = sphere || box || plane;
+
+    uint64_t materialKey = _materialKey(render);
+    uint64_t geometryKey;
+
+    // The full mesh hash is only redone when the renderable reports a mesh write. A revision
+    // of 0 means the mesh was set without one, so its contents are hashed every time.
+    if (analytic) {
+        geometryKey = _geometryKey(render, sphere, box, plane);
+        record.meshRevision = 0;
+    } else {
+        bool unchanged = record.valid && render.meshRevision != 0 && render.meshRevision == record.meshRevision;
+        geometryKey = unchanged ? record.geometryKey : _geometryKey(render, nullptr, nullptr, nullptr);
+        record.meshRevision = render.meshRevision;
+    }
+
+    bool materialChanged = !record.valid || materialKey != record.materialKey;
+    bool geometryChanged = !record.valid || geometryKey != record.geometryKey;
+    bool transformChanged = !record.valid || transform.matrix != record.matrix;
+
+    if (!materialChanged && !geometryChanged && !transformChanged) return false;
+
+    if (materialChanged) {
+        // Acquire before releasing so an unchanged description keeps its slot.
+        uint32_t material = this->_materials.acquire(_describeMaterial(render));
+        this->_materials.release(record.material);
+        record.material = material;
+        record.materialKey = materialKey;
+    }
+
+    if (geometryChanged) {
+        record.mesh = analytic ? nullptr : this->_acquireMesh(geometryKey, render.mesh);
+        record.geometryKey = geometryKey;
+    }
+
+    // Analytic shapes are cheap enough to rebuild outright; meshes only get a new instance.
+    // Spheres have no geometry of their own and are batched by _rebuildTopLevel.
+    record.isSphere = sphere != nullptr;
+
+    if (sphere) {
+        glm::vec3 center = glm::vec3(transform.matrix * glm::vec4(0, 0, 0, 1));
+        glm::vec3 scale = transform.scale;
+
+        record.sphereCenter = point3(center.x, center.y, center.z);
+        record.sphereRadius = sphere->radius * std::max({scale.x, scale.y, scale.z});
+        record.geometry.reset();
+    } else if (box) {
+        glm::vec3 half = box->dimensions * 0.5f;
+        record.geometry = std::make_shared<OrientedBox>(transform.matrix, Vec3(half.x, half.y, half.z), record.material);
+    } else if (plane) {
+        record.geometry = std::make_shared<FinitePlane>(
+            transform.matrix, plane->size.x * 0.5, plane->size.y * 0.5, record.material
+        );
+    } else if (record.mesh) {
+        record.geometry = std::make_shared<Instance>(record.mesh, transform.matrix, record.material);
+    } else {
+        record.geometry.reset();
+    }
+
+    record.matrix = transform.matrix;
+    record.valid = true;
+
+    return true;
+}
+
+void RaytracingScene::_rebuildTopLevel()
+{
+    this->_cancelRebuild();
+
+    HittableList objects;
+    uint32_t sphereCount = 0;
+
+    this->_sphereSet = std::make_shared<SphereSet>();
+    this->_sphereSetShared = false;
+    this->_sphereObject = invalidSlot;
+
+    for (auto& [id, record] : this->_records) {
+        record.slot = invalidSlot;
+
+        if (record.isSphere) {
+            record.slot = sphereCount++;
+            this->_sphereSet->add(record.sphereCenter, record.sphereRadius, record.material);
+        } else if (record.geometry) {
+            record.slot = static_cast<uint32_t>(objects.objects.size());
+            objects.add(record.geometry);
+        }
+    }
+
+    auto sphereStart = std::chrono::steady_clock::now();
+    this->_sphereSet->build(this->_threadPool);
+
+    if (sphereCount > 0) {
+        this->_sphereObject = static_cast<uint32_t>(objects.objects.size());
+        objects.add(this->_sphereSet);
+        this->_pendingStats.bvhBuildMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - sphereStart).count();
+    } else {
+        this->_sphereSet.reset();
+    }
+
+    if (objects.objects.empty()) {
+        this->_bvh.reset();
+        return;
+    }
+
+    this->_bvh = std::make_shared<Bvh>(objects, this->_threadPool);
+    this->_pendingStats.bvhBuildMilliseconds += this->_bvh->buildStats().buildMilliseconds;
+    this->_addTopLevelStats();
+}
+
+// Moves the changed records' slots without touching the topology: a few node boxes per
+// record. Returns false when there is no tree to refit.
+bool RaytracingScene::_refitTopLevel(const std::vector<const Record*>& moved)
+{
+    if (!this->_bvh) return false;
+
+    auto start = std::chrono::steady_clock::now();
+
+    // A snapshot may be tracing the current tree, so it is copied before being touched;
+    // the copy shares the objects, the sphere set included.
+    if (this->_bvh.use_count() > 1) {
+        this->_bvh = std::make_shared<Bvh>(*this->_bvh);
+        this->_sphereSetShared = true;
+    }
+
+    std::vector<uint32_t> objects;
+    std::vector<uint32_t> spheres;
+
+    for (const Record* record : moved) {
+        if (record->isSphere) {
+            spheres.push_back(record->slot);
+        } else {
+            objects.push_back(record->slot);
+            this->_bvh->setObject(record->slot, record->geometry);
+        }
+    }
+
+    if (!spheres.empty()) {
+        if (this->_sphereSetShared) {
+            this->_sphereSet = std::make_shared<SphereSet>(*this->_sphereSet);
+            this->_bvh->setObject(this->_sphereObject, this->_sphereSet);
+            this->_sphereSetShared = false;
+        }
+
+        for (const Record* record : moved) {
+            if (record->isSphere)
+                this->_sphereSet->setSphere(record->slot, record->sphereCenter, record->sphereRadius, record->material);
+        }
+
+        this->_sphereSet->refit(spheres);
+        objects.push_back(this->_sphereObject);
+    }
+
+    this->_bvh->refit(objects);
+
+    this->_pendingStats.refitMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    this->_addTopLevelStats();
+
+    if (this->_rebuild.valid())
+        this->_movedDuringRebuild.insert(this->_movedDuringRebuild.end(), moved.begin(), moved.end());
+    else if (this->_pendingStats.sahGrowth > rebuildSahGrowth)
+        this->_startRebuild();
+
+    return true;
+}
+
+void RaytracingScene::_addTopLevelStats()
+{
+    double sahGrowth = 1.0;
+
+    if (this->_sphereSet) {
+        this->_pendingStats.bvhNodeCount += this->_sphereSet->bvhStats().nodeCount;
+        this->_pendingStats.bvhNodeBytes += this->_sphereSet->bvhNodeMemory();
+        this->_pendingStats.sphereCount = this->_sphereSet->sphereCount();
+        sahGrowth = this->_sphereSet->sahGrowth();
+    }
+
+    if (this->_bvh) {
+        this->_pendingStats.bvhNodeCount += this->_bvh->nodeCount();
+        this->_pendingStats.bvhNodeBytes += this->_bvh->nodeMemory();
+        this->_pendingStats.topLevelSahCost = this->_bvh->buildStats().sahCost;
+        sahGrowth = std::max(sahGrowth, this->_bvh->sahGrowth());
+    }
+
+    this->_pendingStats.sahGrowth = sahGrowth;
+}
+
+// Rebuilds the top-level tree, and the sphere set if it degraded, on their own thread.
+// Bounds and sphere data are copied up front so the build never reads anything the
+// main thread keeps refitting, and it runs serially to stay off the render's pool.
+void RaytracingScene::_startRebuild()
+{
+    std::vector<Aabb> bounds(this->_bvh->objectCount());
+    for (uint32_t index = 0; index < bounds.size(); index++)
+        bounds[index] = this->_bvh->object(index)->boundingBox();
+
+    std::shared_ptr<SphereSet> spheres;
+
+    if (this->_sphereSet && this->_sphereSet->sahGrowth() > rebuildSahGrowth) {
+        std::vector<const Record*> sphereRecords(this->_sphereSet->sphereCount());
+        for (const auto& [id, record] : this->_records)
+            if (record.isSphere) sphereRecords[record.slot] = &record;
+
+        spheres = std::make_shared<SphereSet>();
+        spheres->reserve(sphereRecords.size());
+        for (const Record* record : sphereRecords)
+            spheres->add(record->sphereCenter, record->sphereRadius, record->material);
+    }
+
+    uint32_t sphereObject = this->_sphereObject;
+
+    this->_movedDuringRebuild.clear();
+    this->_rebuild = std::async(std::launch::async, [bounds = std::move(bounds), spheres, sphereObject]() mutable {
+        Rebuild result;
+
+        if (spheres) {
+            spheres->build();
+            bounds[sphereObject] = spheres->boundingBox();
+        }
+
+        result.tree.build(bounds);
+        result.spheres = std::move(spheres);
+        return result;
+    });
+}
+
+// Swaps in a finished rebuild and replays the refits made while it ran. The geometry is
+// the same, so traces already running on the old tree stay valid and the generation is
+// left alone.
+void RaytracingScene::_finishRebuild()
+{
+    if (!this->_rebuild.valid() || this->_rebuild.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return;
+
+    Rebuild result = this->_rebuild.get();
+
+    if (this->_bvh.use_count() > 1) {
+        this->_bvh = std::make_shared<Bvh>(*this->_bvh);
+        this->_sphereSetShared = true;
+    }
+
+    std::vector<uint32_t> objects;
+    std::vector<uint32_t> spheres;
+
+    for (const Record* record : this->_movedDuringRebuild) {
+        if (record->isSphere) spheres.push_back(record->slot);
+        else objects.push_back(record->slot);
+    }
+
+    if (result.spheres) {
+        for (const Record* record : this->_movedDuringRebuild) {
+            if (record->isSphere)
+                result.spheres->setSphere(record->slot, record->sphereCenter, record->sphereRadius, record->material);
+        }
+
+        result.spheres->refit(spheres);
+        this->_sphereSet = result.spheres;
+        this->_sphereSetShared = false;
+        this->_bvh->setObject(this->_sphereObject, this->_sphereSet);
+        objects.push_back(this->_sphereObject);
+    } else if (!spheres.empty()) {
+        objects.push_back(this->_sphereObject);
+    }
+
+    this->_bvh->setTree(std::move(result.tree));
+    this->_bvh->refit(objects);
+    this->_movedDuringRebuild.clear();
+
+    this->_stats.topLevelSahCost = this->_bvh->buildStats().sahCost;
+    this->_stats.sahGrowth = std::max(this->_bvh->sahGrowth(), this->_sphereSet ? this->_sphereSet->sahGrowth() : 1.0);
+}
+
+// A build cannot be interrupted: a restructure waits for it and drops the result.
+void RaytracingScene::_cancelRebuild()
+{
+    if (this->_rebuild.valid()) {
+        this->_rebuild.wait();
+        this->_rebuild = std::future<Rebuild>();
+    }
+
+    this->_movedDuringRebuild.clear();
+}
+
+MaterialDesc RaytracingScene::_describeMaterial(const Renderable& render)
+{
+    MaterialDesc desc;
+
+    if (!render.material) {
+        desc.color = Color(render.color.r / 255.0, render.color.g / 255.0, render.color.b / 255.0);
+        return desc;
+    }
+
+    const Material* material = render.material;
+    glm::vec3 emissive = material->emissiveReflection;
+    bool isEmissive = emissive.r > 0.01 || emissive.g > 0.01 || emissive.b > 0.01;
+
+    if (isEmissive) {
+        desc.kind = MaterialKind::DiffuseLight;
+        desc.color = Color(
+            emissive.r * (render.color.r / 255.0),
+            emissive.g * (render.color.g / 255.0),
+            emissive.b * (render.color.b / 255.0)
+        );
+        return desc;
+    }
+
+    glm::vec3 diffuse = material->diffuseReflection;
+    Color diffuseColor(
+        diffuse.r * (render.color.r / 255.0),
+        diffuse.g * (render.color.g / 255.0),
+        diffuse.b * (render.color.b / 255.0)
+    );
+
+    bool hasRefraction = material->refractionIndex > 1.01 && material->refractionIndex < 3.0;
+    bool usingPBRWorkflow = material->metallic > 0.01;
+
+    if (hasRefraction) {
+        desc.kind = MaterialKind::Dielectric;
+        desc.parameter = material->refractionIndex;
+        return desc;
+    }
+
+    glm::vec3 tint = material->reflectionTint;
+    Color reflColor(tint.r * diffuseColor.x(), tint.g * diffuseColor.y(), tint.b * diffuseColor.z());
+
+    desc.texture = TextureCache::instance().acquire(material->texture);
+    desc.color = diffuseColor;
+
+    if (usingPBRWorkflow) {
+        if (material->metallic > 0.5) {
+            desc.kind = MaterialKind::Metal;
+            desc.color = reflColor;
+            desc.parameter = material->roughness;
+        }
+        return desc;
+    }
+
+    if (material->reflectivity > 0.1) {
+        desc.kind = MaterialKind::Metal;
+        desc.color = reflColor;
+        desc.parameter = 1.0 - material->reflectivity;
+    }
+
+    return desc;
+}
+
+std::shared_ptr<Mesh> RaytracingScene::_acquireMesh(uint64_t geometryKey, const ofMesh& mesh)
+{
+    if (mesh.getNumVertices() == 0) return nullptr;
+
+    auto cached = this->_meshCache.find(geometryKey);
+    if (cached != this->_meshCache.end()) return cached->second;
+
+    std::shared_ptr<Mesh> rtMesh = this->_convertMesh(mesh);
+    if (rtMesh) this->_meshCache[geometryKey] = rtMesh;
+
+    return rtMesh;
+}
+
+// Builds a bottom-level mesh in object space. It carries no material: each Instance
+// supplies its own, so entities sharing the same mesh data share one BVH.
+std::shared_ptr<Mesh> RaytracingScene::_convertMesh(const ofMesh& mesh)
+{
+    const auto& vertices = mesh.getVertices();
+    const auto& indices = mesh.getIndices();
+
+    const auto& normals = mesh.getNormals();
+    const auto& texCoords = mesh.getTexCoords();
+
+    bool hasNormals = normals.size() == vertices.size();
+    bool hasTexCoords = texCoords.size() == vertices.size();
+    size_t triangleCount = (indices.size() > 0 ? indices.size() : vertices.size()) / 3;
+
+    auto rtMesh = std::make_shared<Mesh>(MaterialTable::invalidIndex);
+    rtMesh->reserve(vertices.size(), triangleCount);
+
+    for (size_t i = 0; i < vertices.size(); i++) {
+        uint32_t vertex = rtMesh->addVertex(point3(vertices[i].x, vertices[i].y, vertices[i].z));
+
+        if (hasNormals) rtMesh->setVertexNormal(vertex, Vec3(normals[i].x, normals[i].y, normals[i].z));
+        if (hasTexCoords) rtMesh->setVertexUV(vertex, texCoords[i].x, texCoords[i].y);
+    }
+
+    if (indices.size() > 0) {
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+            rtMesh->addTriangle(indices[i], indices[i + 1], indices[i + 2]);
+    } else {
+        for (size_t i = 0; i + 2 < vertices.size(); i += 3)
+            rtMesh->addTriangle(static_cast<uint32_t>(i), static_cast<uint32_t>(i + 1), static_cast<uint32_t>(i + 2));
+    }
+
+    if (rtMesh->triangleCount() == 0) return nullptr;
+
+    rtMesh->buildBVH(this->_threadPool);
+
+    const LinearBvh::BuildStats& meshStats = rtMesh->bvhStats();
+    this->_pendingStats.bvhBuildMilliseconds += meshStats.buildMilliseconds;
+    this->_pendingStats.bvhNodeCount += meshStats.nodeCount;
+    this->_pendingStats.bvhNodeBytes += rtMesh->bvhNodeMemory();
+    this->_pendingStats.triangleCount += rtMesh->triangleCount();
+    this->_pendingStats.meshMemoryBytes += rtMesh->memoryUsage();
+
+    return rtMesh;
+}
+
+uint64_t RaytracingScene::_materialKey(const Renderable& render)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    hashBytes(hash, &render.color, sizeof(render.color));
+    hashBytes(hash, &render.material, sizeof(render.material));
+
+    if (render.material) {
+        const Material* material = render.material;
+
+        uint64_t textureIdentity = TextureCache::identity(material->texture);
+
+        hashBytes(hash, &material->texture, sizeof(material->texture));
+        hashBytes(hash, &textureIdentity, sizeof(textureIdentity));
+        hashBytes(hash, &material->diffuseReflection, sizeof(material->diffuseReflection));
+        hashBytes(hash, &material->emissiveReflection, sizeof(material->emissiveReflection));
+        hashBytes(hash, &material->reflectivity, sizeof(material->reflectivity));
+        hashBytes(hash, &material->reflectionTint, sizeof(material->reflectionTint));
+        hashBytes(hash, &material->refractionIndex, sizeof(material->refractionIndex));
+        hashBytes(hash, &material->metallic, sizeof(material->metallic));
+        hashBytes(hash, &material->roughness, sizeof(material->roughness));
+    }
+
+    return hash;
+}
+
+// Buffer addresses, sizes and a strided sample of their elements. Meshes are replaced
+// wholesale (primitive regeneration, displacement, model loading), which moves the
+// buffers or rewrites the sampled words, so this is checked every frame in place of
+// the full hash below.
+// Hashes the mesh buffers word by word: far cheaper than re-triangulating, and it keys
+// the mesh cache by content so identical meshes share one BVH.
+uint64_t RaytracingScene::_geometryKey(const Renderable& render, const Sphere* sphere, const Box* box, const Plane* plane)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    if (sphere) {
+        hashBytes(hash, &sphere->radius, sizeof(sphere->radius));
+        return hash;
+    }
+
+    // Tagged so a box and a plane that happen to share bytes never compare equal.
+    if (box) {
+        hashBytes(hash, "box", 3);
+        hashBytes(hash, &box->dimensions, sizeof(box->dimensions));
+        return hash;
+    }
+
+    if (plane) {
+        hashBytes(hash, "plane", 5);
+        hashBytes(hash, &plane->size, sizeof(plane->size));
+        return hash;
+    }
+
+    const auto& vertices = render.mesh.getVertices();
+    const auto& indices = render.mesh.getIndices();
+
+    auto mixWords = [&hash](const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+        for (size_t offset = 0; offset + sizeof(uint32_t) <= size; offset += sizeof(uint32_t)) {
+            uint32_t word;
+            std::memcpy(&word, bytes + offset, sizeof(word));
+            hash = (hash ^ word) * 0x9e3779b97f4a7c15ULL;
+            hash ^= hash >> 29;
+        }
+    };
+
+    const auto& normals = render.mesh.getNormals();
+    const auto& texCoords = render.mesh.getTexCoords();
+
+    size_t counts[4] = {vertices.size(), indices.size(), normals.size(), texCoords.size()};
+
+    hashBytes(hash, counts, sizeof(counts));
+    mixWords(vertices.data(), vertices.size() * sizeof(vertices[0]));
+    mixWords(indices.data(), indices.size() * sizeof(indices[0]));
+    mixWords(normals.data(), normals.size() * sizeof(normals[0]));
+    mixWords(texCoords.data(), texCoords.size() * sizeof(texCoords[0]));
+
+    return hash;
+}
@@ -0,0 +1,157 @@
+#include "Sampler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+Sampler::Sampler(uint64_t seed) : _seed(seed) {}
+
+void Sampler::startPixelSample(int x, int y, int sampleIndex)
+{
+    this->_x = x;
+    this->_y = y;
+    this->_sampleIndex = sampleIndex;
+    this->_dimension = 0;
+    this->_rng.seed(hashPixelSample(this->_seed, x, y, sampleIndex));
+}
+
+double Sampler::get1D()
+{
+    this->_dimension++;
+    return this->_rng.nextDouble();
+}
+
+void Sampler::get2D(double& u, double& v)
+{
+    this->_dimension += 2;
+    u = this->_rng.nextDouble();
+    v = this->_rng.nextDouble();
+}
+
+std::unique_ptr<Sampler> Sampler::create(SamplerType type, int samplesPerPixel, uint64_t seed)
+{
+    switch (type) {
+        case SamplerType::Stratified: return std::make_unique<StratifiedSampler>(samplesPerPixel, seed);
+        case SamplerType::Sobol: return std::make_unique<SobolSampler>(seed);
+        case SamplerType::Independent:
+        default: return std::make_unique<IndependentSampler>(seed);
+    }
+}
+
+uint64_t Sampler::hashPixelSample(uint64_t seed, int x, int y, int sampleIndex)
+{
+    uint64_t h = seed ^ 0x9e3779b97f4a7c15ULL;
+    uint64_t values[3] = {
+        static_cast<uint32_t>(x),
+        static_cast<uint32_t>(y),
+        static_cast<uint32_t>(sampleIndex)
+    };
+
+    for (uint64_t value : values) {
+        h ^= value + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+    }
+
+    return h;
+}
+
+IndependentSampler::IndependentSampler(uint64_t seed) : Sampler(seed) {}
+
+StratifiedSampler::StratifiedSampler(int samplesPerPixel, uint64_t seed) : Sampler(seed)
+{
+    this->_strataPerAxis = std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(samplesPerPixel)))));
+}
+
+void StratifiedSampler::get2D(double& u, double& v)
+{
+    if (this->_dimension != 0) {
+        Sampler::get2D(u, v);
+        return;
+    }
+
+    int strataCount = this->_strataPerAxis * this->_strataPerAxis;
+    uint64_t pixelOffset = hashPixelSample(this->_seed, this->_x, this->_y, 0) % strataCount;
+    int stratum = static_cast<int>((this->_sampleIndex + pixelOffset) % strataCount);
+
+    double jitterU = this->_rng.nextDouble();
+    double jitterV = this->_rng.nextDouble();
+
+    u = ((stratum % this->_strataPerAxis) + jitterU) / this->_strataPerAxis;
+    v = ((stratum / this->_strataPerAxis) + jitterV) / this->_strataPerAxis;
+
+    this->_dimension += 2;
+}
+
+SobolSampler::SobolSampler(uint64_t seed) : Sampler(seed) {}
+
+void SobolSampler::startPixelSample(int x, int y, int sampleIndex)
+{
+    Sampler::startPixelSample(x, y, sampleIndex);
+    this->_pixelHash = static_cast<uint32_t>(hashPixelSample(this->_seed, x, y, -1));
+}
+
+double SobolSampler::get1D()
+{
+    if (this->_dimension >= 2) return Sampler::get1D();
+
+    int dimension = this->_dimension++;
+    uint32_t index = _nestedUniformScramble(static_cast<uint32_t>(this->_sampleIndex), this->_pixelHash);
+    uint32_t value = _nestedUniformScramble(_sobol(index, dimension), _hash(this->_pixelHash + dimension));
+
+    return value * (1.0 / 4294967296.0);
+}
+
+void SobolSampler::get2D(double& u, double& v)
+{
+    if (this->_dimension != 0) {
+        Sampler::get2D(u, v);
+        return;
+    }
+
+    u = this->get1D();
+    v = this->get1D();
+}
+
+uint32_t SobolSampler::_sobol(uint32_t index, int dimension)
+{
+    if (dimension == 0) return _reverseBits(index);
+
+    uint32_t result = 0;
+    for (uint32_t v = 1u << 31; index; index >>= 1, v ^= v >> 1)
+        if (index & 1u) result ^= v;
+
+    return result;
+}
+
+uint32_t SobolSampler::_reverseBits(uint32_t x)
+{
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0f0f0f0fu) | ((x & 0x0f0f0f0fu) << 4);
+    x = ((x >> 8) & 0x00ff00ffu) | ((x & 0x00ff00ffu) << 8);
+    return (x >> 16) | (x << 16);
+}
+
+// Laine-Karras style hash applied in reversed bit order (Burley 2020), an Owen scramble
+// that keeps the (0,2)-sequence stratification of the first two Sobol dimensions.
+uint32_t SobolSampler::_nestedUniformScramble(uint32_t x, uint32_t seed)
+{
+    x = _reverseBits(x);
+    x += seed;
+    x ^= x * 0x6c50b47cu;
+    x ^= x * 0xb82f1e52u;
+    x ^= x * 0xc7afe638u;
+    x ^= x * 0x8d22f6e6u;
+    return _reverseBits(x);
+}
+
+uint32_t SobolSampler::_hash(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
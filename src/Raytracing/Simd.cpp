@@ -0,0 +1,581 @@
+#include "Simd.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+    #define RT_SIMD_X86 1
+#endif
+
+SimdRay::SimdRay(const Ray& r, const Interval& rayT)
+{
+    for (int axis = 0; axis < 3; axis++) {
+        this->origin[axis] = static_cast<float>(r.origin()[axis]);
+        this->direction[axis] = static_cast<float>(r.direction()[axis]);
+        this->invDirection[axis] = 1.0f / this->direction[axis];
+    }
+
+    this->tMin = static_cast<float>(rayT.min);
+}
+
+namespace {
+    const float triangleEpsilon = 1e-12f;
+
+    // Rows holding the entry / exit planes per axis, picked from the ray direction signs
+    // so the kernels need no per-lane min/max.
+    void slabRows(const SimdRay& ray, int nearRow[3], int farRow[3])
+    {
+        for (int axis = 0; axis < 3; axis++) {
+            bool negative = ray.invDirection[axis] < 0.0f;
+            nearRow[axis] = negative ? axis + 3 : axis;
+            farRow[axis] = negative ? axis : axis + 3;
+        }
+    }
+
+    int intersectBoxesScalar(int width, const float* bounds, const SimdRay& ray, float tMax, float* tNear)
+    {
+        int nearRow[3], farRow[3];
+        slabRows(ray, nearRow, farRow);
+
+        int mask = 0;
+
+        for (int lane = 0; lane < width; lane++) {
+            float enter = ray.tMin;
+            float exit = tMax;
+
+            for (int axis = 0; axis < 3; axis++) {
+                enter = std::max(enter, (bounds[nearRow[axis] * width + lane] - ray.origin[axis]) * ray.invDirection[axis]);
+                exit = std::min(exit, (bounds[farRow[axis] * width + lane] - ray.origin[axis]) * ray.invDirection[axis]);
+            }
+
+            tNear[lane] = enter;
+            if (enter <= exit) mask |= 1 << lane;
+        }
+
+        return mask;
+    }
+
+    int intersectQuantizedBoxesScalar(int width, const uint8_t* bounds, const float origin[3], const float scale[3], const SimdRay& ray, float tMax, float* tNear)
+    {
+        int nearRow[3], farRow[3];
+        slabRows(ray, nearRow, farRow);
+
+        int mask = 0;
+
+        for (int lane = 0; lane < width; lane++) {
+            float enter = ray.tMin;
+            float exit = tMax;
+
+            for (int axis = 0; axis < 3; axis++) {
+                float nearPlane = bounds[nearRow[axis] * width + lane] * scale[axis] + origin[axis];
+                float farPlane = bounds[farRow[axis] * width + lane] * scale[axis] + origin[axis];
+
+                enter = std::max(enter, (nearPlane - ray.origin[axis]) * ray.invDirection[axis]);
+                exit = std::min(exit, (farPlane - ray.origin[axis]) * ray.invDirection[axis]);
+            }
+
+            tNear[lane] = enter;
+            if (enter <= exit) mask |= 1 << lane;
+        }
+
+        return mask;
+    }
+
+    int intersectTrianglesScalar(int width, const float* tri, const SimdRay& ray, float tMax, float& tHit, float& uHit, float& vHit)
+    {
+        const float* o = ray.origin;
+        const float* d = ray.direction;
+        int best = -1;
+
+        for (int lane = 0; lane < width; lane++) {
+            float v0[3] = {tri[0 * width + lane], tri[1 * width + lane], tri[2 * width + lane]};
+            float e1[3] = {tri[3 * width + lane], tri[4 * width + lane], tri[5 * width + lane]};
+            float e2[3] = {tri[6 * width + lane], tri[7 * width + lane], tri[8 * width + lane]};
+
+            float h[3] = {d[1] * e2[2] - d[2] * e2[1], d[2] * e2[0] - d[0] * e2[2], d[0] * e2[1] - d[1] * e2[0]};
+            float a = e1[0] * h[0] + e1[1] * h[1] + e1[2] * h[2];
+
+            if (std::fabs(a) < triangleEpsilon) continue;
+
+            float f = 1.0f / a;
+            float s[3] = {o[0] - v0[0], o[1] - v0[1], o[2] - v0[2]};
+            float u = f * (s[0] * h[0] + s[1] * h[1] + s[2] * h[2]);
+
+            if (u < 0.0f || u > 1.0f) continue;
+
+            float q[3] = {s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0]};
+            float v = f * (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]);
+
+            if (v < 0.0f || u + v > 1.0f) continue;
+
+            float t = f * (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]);
+
+            if (t <= ray.tMin || t >= tMax) continue;
+
+            tMax = t;
+            tHit = t;
+            uHit = u;
+            vHit = v;
+            best = lane;
+        }
+
+        return best;
+    }
+
+    // Spheres use the closest-approach form of the quadratic: r^2 - |oc - tc d|^2 keeps its
+    // precision in single floats for small, distant spheres where |oc|^2 - r^2 does not.
+    int intersectSpheresScalar(int width, const float* sph, const SimdRay& ray, float tMax, float& tHit)
+    {
+        const float* o = ray.origin;
+        const float* d = ray.direction;
+        float invA = 1.0f / (d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+        int best = -1;
+
+        for (int lane = 0; lane < width; lane++) {
+            float oc[3] = {sph[0 * width + lane] - o[0], sph[1 * width + lane] - o[1], sph[2 * width + lane] - o[2]};
+            float radius = sph[3 * width + lane];
+
+            float tc = (d[0] * oc[0] + d[1] * oc[1] + d[2] * oc[2]) * invA;
+            float l[3] = {oc[0] - tc * d[0], oc[1] - tc * d[1], oc[2] - tc * d[2]};
+            float q = radius * radius - (l[0] * l[0] + l[1] * l[1] + l[2] * l[2]);
+
+            if (!(q >= 0.0f)) continue;
+
+            float root = std::sqrt(q * invA);
+            float t = tc - root;
+            if (t <= ray.tMin) t = tc + root;
+
+            if (t <= ray.tMin || t >= tMax) continue;
+
+            tMax = t;
+            tHit = t;
+            best = lane;
+        }
+
+        return best;
+    }
+
+#ifdef RT_SIMD_X86
+    __attribute__((target("sse4.2")))
+    int intersectBoxesSse(const float* bounds, const SimdRay& ray, float tMax, float* tNear)
+    {
+        int nearRow[3], farRow[3];
+        slabRows(ray, nearRow, farRow);
+
+        __m128 enter = _mm_set1_ps(ray.tMin);
+        __m128 exit = _mm_set1_ps(tMax);
+
+        for (int axis = 0; axis < 3; axis++) {
+            __m128 origin = _mm_set1_ps(ray.origin[axis]);
+            __m128 inv = _mm_set1_ps(ray.invDirection[axis]);
+
+            __m128 tn = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(bounds + nearRow[axis] * 4), origin), inv);
+            __m128 tf = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(bounds + farRow[axis] * 4), origin), inv);
+
+            // maxps / minps return their second operand when either is NaN (0 * inf for a
+            // ray lying in a slab plane), so the running bound goes second, as std::max keeps it.
+            enter = _mm_max_ps(tn, enter);
+            exit = _mm_min_ps(tf, exit);
+        }
+
+        _mm_storeu_ps(tNear, enter);
+        return _mm_movemask_ps(_mm_cmple_ps(enter, exit));
+    }
+
+    // Widens 4 / 8 consecutive bytes to floats.
+    __attribute__((target("sse4.2")))
+    inline __m128 decodeBytesSse(const uint8_t* bytes)
+    {
+        int32_t packed;
+        std::memcpy(&packed, bytes, sizeof(packed));
+        return _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed)));
+    }
+
+    __attribute__((target("avx2")))
+    inline __m256 decodeBytesAvx(const uint8_t* bytes)
+    {
+        __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(bytes));
+        return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(packed));
+    }
+
+    __attribute__((target("sse4.2")))
+    int intersectQuantizedBoxesSse(const uint8_t* bounds, const float origin[3], const float scale[3], const SimdRay& ray, float tMax, float* tNear)
+    {
+        int nearRow[3], farRow[3];
+        slabRows(ray, nearRow, farRow);
+
+        __m128 enter = _mm_set1_ps(ray.tMin);
+        __m128 exit = _mm_set1_ps(tMax);
+
+        for (int axis = 0; axis < 3; axis++) {
+            __m128 rayOrigin = _mm_set1_ps(ray.origin[axis]);
+            __m128 inv = _mm_set1_ps(ray.invDirection[axis]);
+            __m128 boxOrigin = _mm_set1_ps(origin[axis]);
+            __m128 boxScale = _mm_set1_ps(scale[axis]);
+
+            __m128 nearPlane = _mm_add_ps(_mm_mul_ps(decodeBytesSse(bounds + nearRow[axis] * 4), boxScale), boxOrigin);
+            __m128 farPlane = _mm_add_ps(_mm_mul_ps(decodeBytesSse(bounds + farRow[axis] * 4), boxScale), boxOrigin);
+
+            enter = _mm_max_ps(_mm_mul_ps(_mm_sub_ps(nearPlane, rayOrigin), inv), enter);
+            exit = _mm_min_ps(_mm_mul_ps(_mm_sub_ps(farPlane, rayOrigin), inv), exit);
+        }
+
+        _mm_storeu_ps(tNear, enter);
+        return _mm_movemask_ps(_mm_cmple_ps(enter, exit));
+    }
+
+    __attribute__((target("sse4.2")))
+    int intersectTrianglesSse(const float* tri, const SimdRay& ray, float tMax, float& tHit, float& uHit, float& vHit)
+    {
+        __m128 dx = _mm_set1_ps(ray.direction[0]);
+        __m128 dy = _mm_set1_ps(ray.direction[1]);
+        __m128 dz = _mm_set1_ps(ray.direction[2]);
+
+        __m128 e1x = _mm_loadu_ps(tri + 12), e1y = _mm_loadu_ps(tri + 16), e1z = _mm_loadu_ps(tri + 20);
+        __m128 e2x = _mm_loadu_ps(tri + 24), e2y = _mm_loadu_ps(tri + 28), e2z = _mm_loadu_ps(tri + 32);
+
+        __m128 hx = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+        __m128 hy = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+        __m128 hz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+
+        __m128 a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, hx), _mm_mul_ps(e1y, hy)), _mm_mul_ps(e1z, hz));
+        __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        __m128 valid = _mm_cmpge_ps(_mm_and_ps(a, absMask), _mm_set1_ps(triangleEpsilon));
+
+        __m128 f = _mm_div_ps(_mm_set1_ps(1.0f), a);
+        __m128 sx = _mm_sub_ps(_mm_set1_ps(ray.origin[0]), _mm_loadu_ps(tri + 0));
+        __m128 sy = _mm_sub_ps(_mm_set1_ps(ray.origin[1]), _mm_loadu_ps(tri + 4));
+        __m128 sz = _mm_sub_ps(_mm_set1_ps(ray.origin[2]), _mm_loadu_ps(tri + 8));
+
+        __m128 u = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, hx), _mm_mul_ps(sy, hy)), _mm_mul_ps(sz, hz)));
+
+        __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+        __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+        __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+
+        __m128 v = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)));
+        __m128 t = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)));
+
+        __m128 zero = _mm_setzero_ps();
+        __m128 one = _mm_set1_ps(1.0f);
+
+        valid = _mm_and_ps(valid, _mm_cmpge_ps(u, zero));
+        valid = _mm_and_ps(valid, _mm_cmpge_ps(v, zero));
+        valid = _mm_and_ps(valid, _mm_cmple_ps(_mm_add_ps(u, v), one));
+        valid = _mm_and_ps(valid, _mm_cmpgt_ps(t, _mm_set1_ps(ray.tMin)));
+        valid = _mm_and_ps(valid, _mm_cmplt_ps(t, _mm_set1_ps(tMax)));
+
+        int mask = _mm_movemask_ps(valid);
+        if (!mask) return -1;
+
+        alignas(16) float ts[4], us[4], vs[4];
+        _mm_store_ps(ts, t);
+        _mm_store_ps(us, u);
+        _mm_store_ps(vs, v);
+
+        int best = -1;
+        for (int lane = 0; lane < 4; lane++) {
+            if ((mask & (1 << lane)) && (best < 0 || ts[lane] < ts[best])) best = lane;
+        }
+
+        tHit = ts[best];
+        uHit = us[best];
+        vHit = vs[best];
+        return best;
+    }
+
+    __attribute__((target("sse4.2")))
+    int intersectSpheresSse(const float* sph, const SimdRay& ray, float tMax, float& tHit)
+    {
+        __m128 dx = _mm_set1_ps(ray.direction[0]);
+        __m128 dy = _mm_set1_ps(ray.direction[1]);
+        __m128 dz = _mm_set1_ps(ray.direction[2]);
+        __m128 invA = _mm_set1_ps(1.0f / (ray.direction[0] * ray.direction[0] + ray.direction[1] * ray.direction[1] + ray.direction[2] * ray.direction[2]));
+
+        __m128 ocx = _mm_sub_ps(_mm_loadu_ps(sph + 0), _mm_set1_ps(ray.origin[0]));
+        __m128 ocy = _mm_sub_ps(_mm_loadu_ps(sph + 4), _mm_set1_ps(ray.origin[1]));
+        __m128 ocz = _mm_sub_ps(_mm_loadu_ps(sph + 8), _mm_set1_ps(ray.origin[2]));
+        __m128 radius = _mm_loadu_ps(sph + 12);
+
+        __m128 tc = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, ocx), _mm_mul_ps(dy, ocy)), _mm_mul_ps(dz, ocz)), invA);
+        __m128 lx = _mm_sub_ps(ocx, _mm_mul_ps(tc, dx));
+        __m128 ly = _mm_sub_ps(ocy, _mm_mul_ps(tc, dy));
+        __m128 lz = _mm_sub_ps(ocz, _mm_mul_ps(tc, dz));
+        __m128 q = _mm_sub_ps(
+            _mm_mul_ps(radius, radius),
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(lx, lx), _mm_mul_ps(ly, ly)), _mm_mul_ps(lz, lz))
+        );
+        __m128 valid = _mm_cmpge_ps(q, _mm_setzero_ps());
+
+        __m128 root = _mm_sqrt_ps(_mm_mul_ps(_mm_max_ps(q, _mm_setzero_ps()), invA));
+        __m128 tMin = _mm_set1_ps(ray.tMin);
+        __m128 tNear = _mm_sub_ps(tc, root);
+        __m128 t = _mm_blendv_ps(_mm_add_ps(tc, root), tNear, _mm_cmpgt_ps(tNear, tMin));
+
+        valid = _mm_and_ps(valid, _mm_cmpgt_ps(t, tMin));
+        valid = _mm_and_ps(valid, _mm_cmplt_ps(t, _mm_set1_ps(tMax)));
+
+        int mask = _mm_movemask_ps(valid);
+        if (!mask) return -1;
+
+        alignas(16) float ts[4];
+        _mm_store_ps(ts, t);
+
+        int best = -1;
+        for (int lane = 0; lane < 4; lane++) {
+            if ((mask & (1 << lane)) && (best < 0 || ts[lane] < ts[best])) best = lane;
+        }
+
+        tHit = ts[best];
+        return best;
+    }
+
+    __attribute__((target("avx2")))
+    int intersectBoxesAvx(const float* bounds, const SimdRay& ray, float tMax, float* tNear)
+    {
+        int nearRow[3], farRow[3];
+        slabRows(ray, nearRow, farRow);
+
+        __m256 enter = _mm256_set1_ps(ray.tMin);
+        __m256 exit = _mm256_set1_ps(tMax);
+
+        for (int axis = 0; axis < 3; axis++) {
+            __m256 origin = _mm256_set1_ps(ray.origin[axis]);
+            __m256 inv = _mm256_set1_ps(ray.invDirection[axis]);
+
+            __m256 tn = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(bounds + nearRow[axis] * 8), origin), inv);
+            __m256 tf = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(bounds + farRow[axis] * 8), origin), inv);
+
+            enter = _mm256_max_ps(tn, enter);
+            exit = _mm256_min_ps(tf, exit);
+        }
+
+        _mm256_storeu_ps(tNear, enter);
+        return _mm256_movemask_ps(_mm256_cmp_ps(enter, exit, _CMP_LE_OQ));
+    }
+
+    __attribute__((target("avx2")))
+    int intersectQuantizedBoxesAvx(const uint8_t* bounds, const float origin[3], const float scale[3], const SimdRay& ray, float tMax, float* tNear)
+    {
+        int nearRow[3], farRow[3];
+        slabRows(ray, nearRow, farRow);
+
+        __m256 enter = _mm256_set1_ps(ray.tMin);
+        __m256 exit = _mm256_set1_ps(tMax);
+
+        for (int axis = 0; axis < 3; axis++) {
+            __m256 rayOrigin = _mm256_set1_ps(ray.origin[axis]);
+            __m256 inv = _mm256_set1_ps(ray.invDirection[axis]);
+            __m256 boxOrigin = _mm256_set1_ps(origin[axis]);
+            __m256 boxScale = _mm256_set1_ps(scale[axis]);
+
+            __m256 nearPlane = _mm256_add_ps(_mm256_mul_ps(decodeBytesAvx(bounds + nearRow[axis] * 8), boxScale), boxOrigin);
+            __m256 farPlane = _mm256_add_ps(_mm256_mul_ps(decodeBytesAvx(bounds + farRow[axis] * 8), boxScale), boxOrigin);
+
+            enter = _mm256_max_ps(_mm256_mul_ps(_mm256_sub_ps(nearPlane, rayOrigin), inv), enter);
+            exit = _mm256_min_ps(_mm256_mul_ps(_mm256_sub_ps(farPlane, rayOrigin), inv), exit);
+        }
+
+        _mm256_storeu_ps(tNear, enter);
+        return _mm256_movemask_ps(_mm256_cmp_ps(enter, exit, _CMP_LE_OQ));
+    }
+
+    __attribute__((target("avx2")))
+    int intersectTrianglesAvx(const float* tri, const SimdRay& ray, float tMax, float& tHit, float& uHit, float& vHit)
+    {
+        __m256 dx = _mm256_set1_ps(ray.direction[0]);
+        __m256 dy = _mm256_set1_ps(ray.direction[1]);
+        __m256 dz = _mm256_set1_ps(ray.direction[2]);
+
+        __m256 e1x = _mm256_loadu_ps(tri + 24), e1y = _mm256_loadu_ps(tri + 32), e1z = _mm256_loadu_ps(tri + 40);
+        __m256 e2x = _mm256_loadu_ps(tri + 48), e2y = _mm256_loadu_ps(tri + 56), e2z = _mm256_loadu_ps(tri + 64);
+
+        __m256 hx = _mm256_sub_ps(_mm256_mul_ps(dy, e2z), _mm256_mul_ps(dz, e2y));
+        __m256 hy = _mm256_sub_ps(_mm256_mul_ps(dz, e2x), _mm256_mul_ps(dx, e2z));
+        __m256 hz = _mm256_sub_ps(_mm256_mul_ps(dx, e2y), _mm256_mul_ps(dy, e2x));
+
+        __m256 a = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e1x, hx), _mm256_mul_ps(e1y, hy)), _mm256_mul_ps(e1z, hz));
+        __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+        __m256 valid = _mm256_cmp_ps(_mm256_and_ps(a, absMask), _mm256_set1_ps(triangleEpsilon), _CMP_GE_OQ);
+
+        __m256 f = _mm256_div_ps(_mm256_set1_ps(1.0f), a);
+        __m256 sx = _mm256_sub_ps(_mm256_set1_ps(ray.origin[0]), _mm256_loadu_ps(tri + 0));
+        __m256 sy = _mm256_sub_ps(_mm256_set1_ps(ray.origin[1]), _mm256_loadu_ps(tri + 8));
+        __m256 sz = _mm256_sub_ps(_mm256_set1_ps(ray.origin[2]), _mm256_loadu_ps(tri + 16));
+
+        __m256 u = _mm256_mul_ps(f, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(sx, hx), _mm256_mul_ps(sy, hy)), _mm256_mul_ps(sz, hz)));
+
+        __m256 qx = _mm256_sub_ps(_mm256_mul_ps(sy, e1z), _mm256_mul_ps(sz, e1y));
+        __m256 qy = _mm256_sub_ps(_mm256_mul_ps(sz, e1x), _mm256_mul_ps(sx, e1z));
+        __m256 qz = _mm256_sub_ps(_mm256_mul_ps(sx, e1y), _mm256_mul_ps(sy, e1x));
+
+        __m256 v = _mm256_mul_ps(f, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, qx), _mm256_mul_ps(dy, qy)), _mm256_mul_ps(dz, qz)));
+        __m256 t = _mm256_mul_ps(f, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(e2x, qx), _mm256_mul_ps(e2y, qy)), _mm256_mul_ps(e2z, qz)));
+
+        __m256 zero = _mm256_setzero_ps();
+        __m256 one = _mm256_set1_ps(1.0f);
+
+        valid = _mm256_and_ps(valid, _mm256_cmp_ps(u, zero, _CMP_GE_OQ));
+        valid = _mm256_and_ps(valid, _mm256_cmp_ps(v, zero, _CMP_GE_OQ));
+        valid = _mm256_and_ps(valid, _mm256_cmp_ps(_mm256_add_ps(u, v), one, _CMP_LE_OQ));
+        valid = _mm256_and_ps(valid, _mm256_cmp_ps(t, _mm256_set1_ps(ray.tMin), _CMP_GT_OQ));
+        valid = _mm256_and_ps(valid, _mm256_cmp_ps(t, _mm256_set1_ps(tMax), _CMP_LT_OQ));
+
+        int mask = _mm256_movemask_ps(valid);
+        if (!mask) return -1;
+
+        alignas(32) float ts[8], us[8], vs[8];
+        _mm256_store_ps(ts, t);
+        _mm256_store_ps(us, u);
+        _mm256_store_ps(vs, v);
+
+        int best = -1;
+        for (int lane = 0; lane < 8; lane++) {
+            if ((mask & (1 << lane)) && (best < 0 || ts[lane] < ts[best])) best = lane;
+        }
+
+        tHit = ts[best];
+        uHit = us[best];
+        vHit = vs[best];
+        return best;
+    }
+
+    __attribute__((target("avx2")))
+    int intersectSpheresAvx(const float* sph, const SimdRay& ray, float tMax, float& tHit)
+    {
+        __m256 dx = _mm256_set1_ps(ray.direction[0]);
+        __m256 dy = _mm256_set1_ps(ray.direction[1]);
+        __m256 dz = _mm256_set1_ps(ray.direction[2]);
+        __m256 invA = _mm256_set1_ps(1.0f / (ray.direction[0] * ray.direction[0] + ray.direction[1] * ray.direction[1] + ray.direction[2] * ray.direction[2]));
+
+        __m256 ocx = _mm256_sub_ps(_mm256_loadu_ps(sph + 0), _mm256_set1_ps(ray.origin[0]));
+        __m256 ocy = _mm256_sub_ps(_mm256_loadu_ps(sph + 8), _mm256_set1_ps(ray.origin[1]));
+        __m256 ocz = _mm256_sub_ps(_mm256_loadu_ps(sph + 16), _mm256_set1_ps(ray.origin[2]));
+        __m256 radius = _mm256_loadu_ps(sph + 24);
+
+        __m256 tc = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, ocx), _mm256_mul_ps(dy, ocy)), _mm256_mul_ps(dz, ocz)), invA);
+        __m256 lx = _mm256_sub_ps(ocx, _mm256_mul_ps(tc, dx));
+        __m256 ly = _mm256_sub_ps(ocy, _mm256_mul_ps(tc, dy));
+        __m256 lz = _mm256_sub_ps(ocz, _mm256_mul_ps(tc, dz));
+        __m256 q = _mm256_sub_ps(
+            _mm256_mul_ps(radius, radius),
+            _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(lx, lx), _mm256_mul_ps(ly, ly)), _mm256_mul_ps(lz, lz))
+        );
+        __m256 valid = _mm256_cmp_ps(q, _mm256_setzero_ps(), _CMP_GE_OQ);
+
+        __m256 root = _mm256_sqrt_ps(_mm256_mul_ps(_mm256_max_ps(q, _mm256_setzero_ps()), invA));
+        __m256 tMin = _mm256_set1_ps(ray.tMin);
+        __m256 tNear = _mm256_sub_ps(tc, root);
+        __m256 t = _mm256_blendv_ps(_mm256_add_ps(tc, root), tNear, _mm256_cmp_ps(tNear, tMin, _CMP_GT_OQ));
+
+        valid = _mm256_and_ps(valid, _mm256_cmp_ps(t, tMin, _CMP_GT_OQ));
+        valid = _mm256_and_ps(valid, _mm256_cmp_ps(t, _mm256_set1_ps(tMax), _CMP_LT_OQ));
+
+        int mask = _mm256_movemask_ps(valid);
+        if (!mask) return -1;
+
+        alignas(32) float ts[8];
+        _mm256_store_ps(ts, t);
+
+        int best = -1;
+        for (int lane = 0; lane < 8; lane++) {
+            if ((mask & (1 << lane)) && (best < 0 || ts[lane] < ts[best])) best = lane;
+        }
+
+        tHit = ts[best];
+        return best;
+    }
+#endif
+
+    std::atomic<SimdLevel> maxLevel{SimdLevel::AVX2};
+}
+
+SimdLevel Simd::detectedLevel()
+{
+    static const SimdLevel level = []() {
+#ifdef RT_SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+        if (__builtin_cpu_supports("sse4.2")) return SimdLevel::SSE42;
+#endif
+        return SimdLevel::Scalar;
+    }();
+
+    return level;
+}
+
+SimdLevel Simd::activeLevel()
+{
+    return std::min(detectedLevel(), maxLevel.load(std::memory_order_relaxed));
+}
+
+void Simd::setMaxLevel(SimdLevel level)
+{
+    maxLevel.store(level, std::memory_order_relaxed);
+}
+
+int Simd::preferredWidth()
+{
+    return activeLevel() == SimdLevel::AVX2 ? 8 : 4;
+}
+
+const char* Simd::levelName(SimdLevel level)
+{
+    switch (level) {
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::SSE42: return "SSE4.2";
+        case SimdLevel::Scalar:
+        default: return "Scalar";
+    }
+}
+
+int Simd::intersectBoxes(int width, const float* bounds, const SimdRay& ray, float tMax, float* tNear)
+{
+#ifdef RT_SIMD_X86
+    SimdLevel level = activeLevel();
+
+    if (width == 8 && level == SimdLevel::AVX2) return intersectBoxesAvx(bounds, ray, tMax, tNear);
+    if (width == 4 && level != SimdLevel::Scalar) return intersectBoxesSse(bounds, ray, tMax, tNear);
+#endif
+
+    return intersectBoxesScalar(width, bounds, ray, tMax, tNear);
+}
+
+int Simd::intersectQuantizedBoxes(int width, const uint8_t* bounds, const float origin[3], const float scale[3], const SimdRay& ray, float tMax, float* tNear)
+{
+#ifdef RT_SIMD_X86
+    SimdLevel level = activeLevel();
+
+    if (width == 8 && level == SimdLevel::AVX2) return intersectQuantizedBoxesAvx(bounds, origin, scale, ray, tMax, tNear);
+    if (width == 4 && level != SimdLevel::Scalar) return intersectQuantizedBoxesSse(bounds, origin, scale, ray, tMax, tNear);
+#endif
+
+    return intersectQuantizedBoxesScalar(width, bounds, origin, scale, ray, tMax, tNear);
+}
+
+int Simd::intersectTriangles(int width, const float* triangles, const SimdRay& ray, float tMax, float& t, float& u, float& v)
+{
+#ifdef RT_SIMD_X86
+    SimdLevel level = activeLevel();
+
+    if (width == 8 && level == SimdLevel::AVX2) return intersectTrianglesAvx(triangles, ray, tMax, t, u, v);
+    if (width == 4 && level != SimdLevel::Scalar) return intersectTrianglesSse(triangles, ray, tMax, t, u, v);
+#endif
+
+    return intersectTrianglesScalar(width, triangles, ray, tMax, t, u, v);
+}
+
+int Simd::intersectSpheres(int width, const float* spheres, const SimdRay& ray, float tMax, float& t)
+{
+#ifdef RT_SIMD_X86
+    SimdLevel level = activeLevel();
+
+    if (width == 8 && level == SimdLevel::AVX2) return intersectSpheresAvx(spheres, ray, tMax, t);
+    if (width == 4 && level != SimdLevel::Scalar) return intersectSpheresSse(spheres, ray, tMax, t);
+#endif
+
+    return intersectSpheresScalar(width, spheres, ray, tMax, t);
+}
@@ -0,0 +1,309 @@
+#include "SphereSet.hpp"
+
+#include "MaterialTable.hpp"
+
+#include <algorithm>
+#include <limits>
+
+void SphereSet::reserve(size_t sphereCount)
+{
+    this->_spheres.reserve(sphereCount * 4);
+    this->_materials.reserve(sphereCount);
+}
+
+void SphereSet::add(const point3& center, double radius, uint32_t material)
+{
+    this->_spheres.push_back(static_cast<float>(center.x()));
+    this->_spheres.push_back(static_cast<float>(center.y()));
+    this->_spheres.push_back(static_cast<float>(center.z()));
+    this->_spheres.push_back(static_cast<float>(std::fmax(0.0, radius)));
+    this->_materials.push_back(material);
+}
+
+// Groups the spheres into clusters of at most one SIMD width, packs them and builds the
+// BVH over cluster bounds. Empty lanes get a NaN center so the kernels reject them.
+void SphereSet::build(ThreadPool* threadPool)
+{
+    size_t count = this->_materials.size();
+
+    if (count == 0) return;
+
+    int width = Simd::preferredWidth();
+    std::vector<uint32_t> order;
+    std::vector<uint32_t> clusterStarts;
+    this->_cluster(width, threadPool, order, clusterStarts);
+
+    size_t clusterCount = clusterStarts.size() - 1;
+
+    this->_clusterWidth = width;
+    this->_clusterBlocks.assign(clusterCount * 4 * width, std::numeric_limits<float>::quiet_NaN());
+    this->_clusterMaterials.assign(clusterCount * width, MaterialTable::invalidIndex);
+    this->_sphereLanes.assign(count, 0);
+
+    std::vector<Aabb> bounds;
+    bounds.reserve(clusterCount);
+
+    for (size_t cluster = 0; cluster < clusterCount; cluster++) {
+        float* block = &this->_clusterBlocks[cluster * 4 * width];
+        uint32_t clusterSize = clusterStarts[cluster + 1] - clusterStarts[cluster];
+
+        for (uint32_t lane = 0; lane < clusterSize; lane++) {
+            uint32_t sphere = order[clusterStarts[cluster] + lane];
+            const float* s = &this->_spheres[sphere * 4];
+
+            for (int row = 0; row < 4; row++)
+                block[row * width + lane] = s[row];
+            this->_clusterMaterials[cluster * width + lane] = this->_materials[sphere];
+            this->_sphereLanes[sphere] = static_cast<uint32_t>(cluster * width + lane);
+        }
+
+        bounds.push_back(this->_clusterBounds(static_cast<uint32_t>(cluster)));
+        this->_bbox = (cluster == 0) ? bounds.back() : Aabb::surroundingBox(this->_bbox, bounds.back());
+    }
+
+    this->_bvh.build(bounds, threadPool);
+    this->_count = count;
+    this->_bvhBuilt = true;
+
+    std::vector<float>().swap(this->_spheres);
+    std::vector<uint32_t>().swap(this->_materials);
+}
+
+void SphereSet::setSphere(uint32_t index, const point3& center, double radius, uint32_t material)
+{
+    int width = this->_clusterWidth;
+    uint32_t lane = this->_sphereLanes[index];
+    float* block = &this->_clusterBlocks[(lane / width) * 4 * width];
+
+    block[lane % width] = static_cast<float>(center.x());
+    block[width + lane % width] = static_cast<float>(center.y());
+    block[2 * width + lane % width] = static_cast<float>(center.z());
+    block[3 * width + lane % width] = static_cast<float>(std::fmax(0.0, radius));
+    this->_clusterMaterials[lane] = material;
+}
+
+void SphereSet::refit(const std::vector<uint32_t>& changedSpheres)
+{
+    if (!this->_bvhBuilt) return;
+
+    std::vector<uint32_t> clusters;
+    clusters.reserve(changedSpheres.size());
+
+    for (uint32_t sphere : changedSpheres)
+        clusters.push_back(this->_sphereLanes[sphere] / this->_clusterWidth);
+
+    this->_bvh.refit(clusters, [this](uint32_t cluster) { return this->_clusterBounds(cluster); });
+    this->_bbox = this->_bvh.bounds();
+}
+
+double SphereSet::sahGrowth() const
+{
+    return this->_bvh.sahGrowth();
+}
+
+bool SphereSet::hit(const Ray& r, Interval rayT, HitRecord& rec) const
+{
+    if (!this->_bvhBuilt) return false;
+
+    return this->_bvh.intersect(r, rayT, rec, [this, &r](uint32_t firstSlot, uint32_t count, const SimdRay& ray, Interval t, HitRecord& record) {
+        return this->_hitLeaf(firstSlot, count, ray, r, t, record);
+    });
+}
+
+bool SphereSet::occluded(const Ray& r, Interval rayT) const
+{
+    if (!this->_bvhBuilt) return false;
+
+    const std::vector<uint32_t>& slots = this->_bvh.primitiveSlots();
+    int width = this->_clusterWidth;
+
+    return this->_bvh.occluded(r, rayT, [this, &slots, width](uint32_t firstSlot, uint32_t count, const SimdRay& ray, const Interval& t) {
+        float tMax = static_cast<float>(t.max);
+
+        for (uint32_t slot = firstSlot; slot < firstSlot + count; slot++) {
+            float tHit;
+            const float* block = &this->_clusterBlocks[slots[slot] * 4 * width];
+
+            if (Simd::intersectSpheres(width, block, ray, tMax, tHit) >= 0 && t.surrounds(tHit))
+                return true;
+        }
+
+        return false;
+    });
+}
+
+Aabb SphereSet::boundingBox() const
+{
+    return this->_bbox;
+}
+
+PrimitiveKind SphereSet::primitiveKind() const
+{
+    return PrimitiveKind::SphereSet;
+}
+
+size_t SphereSet::sphereCount() const
+{
+    return this->_count;
+}
+
+size_t SphereSet::memoryUsage() const
+{
+    return this->_clusterBlocks.size() * sizeof(float)
+        + this->_clusterMaterials.size() * sizeof(uint32_t)
+        + this->_sphereLanes.size() * sizeof(uint32_t)
+        + this->_bvh.nodeMemory()
+        + this->_bvh.primitiveSlots().size() * sizeof(uint32_t);
+}
+
+size_t SphereSet::bvhNodeMemory() const
+{
+    return this->_bvh.nodeMemory();
+}
+
+const LinearBvh::BuildStats& SphereSet::bvhStats() const
+{
+    return this->_bvh.buildStats();
+}
+
+// Empty lanes hold NaN centers and are skipped.
+Aabb SphereSet::_clusterBounds(uint32_t cluster) const
+{
+    int width = this->_clusterWidth;
+    const float* block = &this->_clusterBlocks[cluster * 4 * width];
+    Aabb bounds;
+    bool first = true;
+
+    for (int lane = 0; lane < width; lane++) {
+        if (std::isnan(block[lane])) continue;
+
+        point3 center(block[lane], block[width + lane], block[2 * width + lane]);
+        Vec3 rVec(block[3 * width + lane], block[3 * width + lane], block[3 * width + lane]);
+        Aabb sphereBounds(center - rVec, center + rVec);
+
+        bounds = first ? sphereBounds : Aabb::surroundingBox(bounds, sphereBounds);
+        first = false;
+    }
+
+    return bounds;
+}
+
+// Builds a binary SAH tree over the spheres and cuts it at the highest subtrees holding
+// no more than width spheres, so each cluster is spatially tight. Larger leaves are split
+// into consecutive runs. Cluster i holds order[clusterStarts[i] .. clusterStarts[i + 1]).
+void SphereSet::_cluster(int width, ThreadPool* threadPool, std::vector<uint32_t>& order, std::vector<uint32_t>& clusterStarts) const
+{
+    size_t count = this->_materials.size();
+    std::vector<Aabb> bounds;
+    bounds.reserve(count);
+
+    for (size_t sphere = 0; sphere < count; sphere++) {
+        const float* s = &this->_spheres[sphere * 4];
+        Vec3 rVec(s[3], s[3], s[3]);
+        bounds.emplace_back(point3(s[0], s[1], s[2]) - rVec, point3(s[0], s[1], s[2]) + rVec);
+    }
+
+    LinearBvh binary;
+    binary.build(bounds, threadPool);
+
+    const std::vector<LinearBvhNode>& nodes = binary.nodes();
+    const std::vector<uint32_t>& indices = binary.primitiveIndices();
+
+    // Depth-first order puts every subtree's leaves in one contiguous run of indices, so
+    // the sphere count and first index of a subtree come from a reverse sweep.
+    std::vector<uint32_t> subtreeCount(nodes.size());
+    std::vector<uint32_t> subtreeFirst(nodes.size());
+
+    for (size_t i = nodes.size(); i-- > 0;) {
+        const LinearBvhNode& node = nodes[i];
+
+        if (node.isLeaf()) {
+            subtreeCount[i] = node.primitiveCount;
+            subtreeFirst[i] = node.offset;
+        } else {
+            subtreeCount[i] = subtreeCount[i + 1] + subtreeCount[node.offset];
+            subtreeFirst[i] = subtreeFirst[i + 1];
+        }
+    }
+
+    order.clear();
+    order.reserve(count);
+    clusterStarts.assign(1, 0);
+
+    std::vector<uint32_t> stack = {0};
+
+    while (!stack.empty()) {
+        uint32_t index = stack.back();
+        stack.pop_back();
+
+        const LinearBvhNode& node = nodes[index];
+
+        if (subtreeCount[index] <= static_cast<uint32_t>(width) || node.isLeaf()) {
+            for (uint32_t i = 0; i < subtreeCount[index]; i++) {
+                if (i > 0 && i % width == 0) clusterStarts.push_back(static_cast<uint32_t>(order.size()));
+                order.push_back(indices[subtreeFirst[index] + i]);
+            }
+            clusterStarts.push_back(static_cast<uint32_t>(order.size()));
+            continue;
+        }
+
+        stack.push_back(node.offset);
+        stack.push_back(index + 1);
+    }
+}
+
+bool SphereSet::_hitLeaf(uint32_t firstSlot, uint32_t count, const SimdRay& ray, const Ray& r, const Interval& rayT, HitRecord& rec) const
+{
+    const std::vector<uint32_t>& slots = this->_bvh.primitiveSlots();
+    int width = this->_clusterWidth;
+    size_t best = std::numeric_limits<size_t>::max();
+    float tMax = static_cast<float>(rayT.max);
+
+    for (uint32_t slot = firstSlot; slot < firstSlot + count; slot++) {
+        float t;
+        uint32_t cluster = slots[slot];
+        int lane = Simd::intersectSpheres(width, &this->_clusterBlocks[cluster * 4 * width], ray, tMax, t);
+
+        if (lane < 0) continue;
+
+        best = static_cast<size_t>(cluster) * width + lane;
+        tMax = t;
+    }
+
+    if (best == std::numeric_limits<size_t>::max()) return false;
+
+    const float* block = &this->_clusterBlocks[(best / width) * 4 * width];
+    size_t lane = best % width;
+    point3 center(block[lane], block[width + lane], block[2 * width + lane]);
+    double radius = block[3 * width + lane];
+
+    // Same solve as Spheres::hit, so both paths agree on t, normal and UVs.
+    Vec3 oc = center - r.origin();
+    double a = r.direction().lengthSquared();
+    double h = dot(r.direction(), oc);
+    double c = oc.lengthSquared() - radius * radius;
+    double discriminant = h * h - a * c;
+    if (discriminant < 0) return false;
+
+    double root = std::sqrt(discriminant);
+
+    double t = (h - root) / a;
+    if (!rayT.surrounds(t)) {
+        t = (h + root) / a;
+        if (!rayT.surrounds(t)) return false;
+    }
+
+    rec.t = t;
+    rec.p = r.at(rec.t);
+    Vec3 outwardNormal = (rec.p - center) / radius;
+    rec.setFaceNormal(r, outwardNormal);
+    rec.material = this->_clusterMaterials[best];
+
+    double theta = std::atan2(-outwardNormal.z(), outwardNormal.x()) + M_PI;
+    double phi = std::acos(-outwardNormal.y());
+    rec.u = theta / (2.0 * M_PI);
+    rec.v = phi / M_PI;
+    rec.uvDensity = 1.0 / (2.0 * std::sqrt(M_PI) * std::fabs(radius));
+
+    return true;
+}
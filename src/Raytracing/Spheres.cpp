@@ -1,10 +1,10 @@
 #include "Spheres.hpp"
 
-Spheres::Spheres(const point3& center, double radius, std::shared_ptr<Materials> mat)
+Spheres::Spheres(const point3& center, double radius, uint32_t material)
 {
     this->_center = center;
     this->_radius = std::fmax(0.0, radius);
-    this->_mat = mat;
+    this->_material = material;
 
     Vec3 rVec(this->_radius, this->_radius, this->_radius);
     this->_bbox = Aabb(this->_center - rVec, this->_center + rVec);
@@ -32,17 +32,39 @@ bool Spheres::hit(const Ray& r, Interval rayT, HitRecord& rec) const
     rec.p = r.at(rec.t);
     Vec3 outwardNormal = (rec.p - this->_center) / this->_radius;
     rec.setFaceNormal(r, outwardNormal);
-    rec.mat = this->_mat;
+    rec.material = this->_material;
 
     double theta = std::atan2(-outwardNormal.z(), outwardNormal.x()) + M_PI;
     double phi = std::acos(-outwardNormal.y());
     rec.u = theta / (2.0 * M_PI);
     rec.v = phi / M_PI;
+    // The unit UV square covers 4 pi r^2; the stretch near the poles is ignored.
+    rec.uvDensity = 1.0 / (2.0 * std::sqrt(M_PI) * std::fabs(this->_radius));
 
     return true;
 }
 
+bool Spheres::occluded(const Ray& r, Interval rayT) const
+{
+    Vec3 oc = this->_center - r.origin();
+    auto a = r.direction().lengthSquared();
+    auto h = dot(r.direction(), oc);
+    auto c = oc.lengthSquared() - this->_radius * this->_radius;
+
+    auto discriminant = h * h - a * c;
+    if (discriminant < 0) return false;
+
+    auto sqrtd = std::sqrt(discriminant);
+
+    return rayT.surrounds((h - sqrtd) / a) || rayT.surrounds((h + sqrtd) / a);
+}
+
 Aabb Spheres::boundingBox() const
 {
     return this->_bbox;
 }
+
+PrimitiveKind Spheres::primitiveKind() const
+{
+    return PrimitiveKind::Sphere;
+}
@@ -0,0 +1,208 @@
+#include "TextureCache.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+CpuTexture::CpuTexture(const ofPixels& pixels)
+{
+    const unsigned char* data = pixels.getData();
+    int width = static_cast<int>(pixels.getWidth());
+    int height = static_cast<int>(pixels.getHeight());
+    size_t channels = pixels.getNumChannels();
+
+    if (!data || width <= 0 || height <= 0 || channels == 0) return;
+
+    Level base;
+    base.width = width;
+    base.height = height;
+    base.texels.resize(static_cast<size_t>(width) * height * 4);
+
+    for (size_t i = 0; i < static_cast<size_t>(width) * height; i++) {
+        const unsigned char* src = data + i * channels;
+        uint8_t* dst = &base.texels[i * 4];
+
+        dst[0] = src[0];
+        dst[1] = channels >= 3 ? src[1] : src[0];
+        dst[2] = channels >= 3 ? src[2] : src[0];
+        dst[3] = channels == 4 ? src[3] : (channels == 2 ? src[1] : 255);
+    }
+
+    this->_levels.push_back(std::move(base));
+    this->_buildMipChain();
+}
+
+bool CpuTexture::empty() const
+{
+    return this->_levels.empty();
+}
+
+int CpuTexture::levelCount() const
+{
+    return static_cast<int>(this->_levels.size());
+}
+
+size_t CpuTexture::memoryUsage() const
+{
+    size_t bytes = 0;
+
+    for (const Level& level : this->_levels)
+        bytes += level.texels.size();
+
+    return bytes;
+}
+
+Color CpuTexture::sampleBilinear(double u, double v, int level) const
+{
+    if (this->_levels.empty()) return Color(1, 1, 1);
+
+    const Level& mip = this->_levels[std::clamp(level, 0, this->levelCount() - 1)];
+
+    double x = std::clamp(u, 0.0, 1.0) * (mip.width - 1);
+    double y = std::clamp(v, 0.0, 1.0) * (mip.height - 1);
+    int x0 = static_cast<int>(x);
+    int y0 = static_cast<int>(y);
+    int x1 = std::min(x0 + 1, mip.width - 1);
+    int y1 = std::min(y0 + 1, mip.height - 1);
+    double fx = x - x0;
+    double fy = y - y0;
+
+    Color top = (1.0 - fx) * this->_texel(mip, x0, y0) + fx * this->_texel(mip, x1, y0);
+    Color bottom = (1.0 - fx) * this->_texel(mip, x0, y1) + fx * this->_texel(mip, x1, y1);
+
+    return (1.0 - fy) * top + fy * bottom;
+}
+
+Color CpuTexture::sampleTrilinear(double u, double v, double lod) const
+{
+    if (this->_levels.empty()) return Color(1, 1, 1);
+
+    lod = std::clamp(lod, 0.0, static_cast<double>(this->levelCount() - 1));
+
+    int fine = static_cast<int>(lod);
+    double blend = lod - fine;
+
+    if (blend <= 0.0) return this->sampleBilinear(u, v, fine);
+
+    return (1.0 - blend) * this->sampleBilinear(u, v, fine) + blend * this->sampleBilinear(u, v, fine + 1);
+}
+
+Color CpuTexture::sampleFootprint(double u, double v, double footprint) const
+{
+    if (this->_levels.empty() || footprint <= 0.0) return this->sampleBilinear(u, v);
+
+    double texels = footprint * std::max(this->_levels[0].width, this->_levels[0].height);
+
+    return this->sampleTrilinear(u, v, texels > 1.0 ? std::log2(texels) : 0.0);
+}
+
+// 2x2 box filter down to 1x1; odd edges reuse the last row or column.
+void CpuTexture::_buildMipChain()
+{
+    while (this->_levels.back().width > 1 || this->_levels.back().height > 1) {
+        const Level& source = this->_levels.back();
+        Level next;
+        next.width = std::max(1, source.width / 2);
+        next.height = std::max(1, source.height / 2);
+        next.texels.resize(static_cast<size_t>(next.width) * next.height * 4);
+
+        for (int y = 0; y < next.height; y++) {
+            int y0 = std::min(y * 2, source.height - 1);
+            int y1 = std::min(y * 2 + 1, source.height - 1);
+
+            for (int x = 0; x < next.width; x++) {
+                int x0 = std::min(x * 2, source.width - 1);
+                int x1 = std::min(x * 2 + 1, source.width - 1);
+
+                for (int c = 0; c < 4; c++) {
+                    int sum = source.texels[(static_cast<size_t>(y0) * source.width + x0) * 4 + c]
+                        + source.texels[(static_cast<size_t>(y0) * source.width + x1) * 4 + c]
+                        + source.texels[(static_cast<size_t>(y1) * source.width + x0) * 4 + c]
+                        + source.texels[(static_cast<size_t>(y1) * source.width + x1) * 4 + c];
+                    next.texels[(static_cast<size_t>(y) * next.width + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+
+        this->_levels.push_back(std::move(next));
+    }
+}
+
+Color CpuTexture::_texel(const Level& level, int x, int y) const
+{
+    const uint8_t* texel = &level.texels[(static_cast<size_t>(y) * level.width + x) * 4];
+    return Color(texel[0] / 255.0, texel[1] / 255.0, texel[2] / 255.0);
+}
+
+TextureCache& TextureCache::instance()
+{
+    static TextureCache cache;
+    return cache;
+}
+
+std::shared_ptr<const CpuTexture> TextureCache::acquire(const ofTexture* texture)
+{
+    if (!texture || !texture->isAllocated()) return nullptr;
+
+    uint64_t textureIdentity = identity(texture);
+    std::lock_guard<std::mutex> lock(this->_mutex);
+
+    Entry& entry = this->_entries[texture];
+
+    if (entry.texture && entry.identity == textureIdentity)
+        return entry.texture;
+
+    ofPixels pixels;
+    texture->readToPixels(pixels);
+
+    auto cpuTexture = std::make_shared<CpuTexture>(pixels);
+
+    entry.identity = textureIdentity;
+    entry.texture = cpuTexture->empty() ? nullptr : cpuTexture;
+    this->_generation++;
+
+    return entry.texture;
+}
+
+void TextureCache::purgeUnused()
+{
+    std::lock_guard<std::mutex> lock(this->_mutex);
+
+    for (auto it = this->_entries.begin(); it != this->_entries.end();) {
+        if (!it->second.texture || it->second.texture.use_count() == 1) it = this->_entries.erase(it);
+        else ++it;
+    }
+}
+
+void TextureCache::clear()
+{
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    this->_entries.clear();
+}
+
+uint64_t TextureCache::generation() const
+{
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    return this->_generation;
+}
+
+size_t TextureCache::memoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(this->_mutex);
+    size_t bytes = 0;
+
+    for (const auto& [texture, entry] : this->_entries)
+        if (entry.texture) bytes += entry.texture->memoryUsage();
+
+    return bytes;
+}
+
+uint64_t TextureCache::identity(const ofTexture* texture)
+{
+    if (!texture || !texture->isAllocated()) return 0;
+
+    uint64_t id = texture->getTextureData().textureID;
+    uint64_t width = static_cast<uint64_t>(texture->getWidth());
+    uint64_t height = static_cast<uint64_t>(texture->getHeight());
+
+    return (id << 32) ^ (width << 16) ^ height;
+}
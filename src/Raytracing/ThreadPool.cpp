@@ -0,0 +1,145 @@
+#include "ThreadPool.hpp"
+
+ThreadPool::ThreadPool(size_t threadCount)
+{
+    this->_start(threadCount == 0 ? defaultThreadCount() : threadCount);
+}
+
+ThreadPool::~ThreadPool()
+{
+    this->_stop();
+}
+
+void ThreadPool::resize(size_t threadCount)
+{
+    if (threadCount == 0) threadCount = defaultThreadCount();
+    if (threadCount == this->_workers.size()) return;
+
+    std::lock_guard<std::mutex> jobLock(this->_jobMutex);
+
+    this->_stop();
+    this->_start(threadCount);
+}
+
+size_t ThreadPool::size() const
+{
+    return this->_workers.size();
+}
+
+void ThreadPool::parallelFor(size_t count, const Task& task)
+{
+    if (count == 0) return;
+
+    std::lock_guard<std::mutex> jobLock(this->_jobMutex);
+
+    size_t workerCount = this->_workers.size();
+
+    if (workerCount <= 1 || count == 1) {
+        for (size_t i = 0; i < count; i++) task(i, 0);
+        return;
+    }
+
+    for (size_t w = 0; w < workerCount; w++) {
+        size_t begin = w * count / workerCount;
+        size_t end = (w + 1) * count / workerCount;
+
+        std::lock_guard<std::mutex> queueLock(this->_queues[w]->mutex);
+        for (size_t i = begin; i < end; i++) this->_queues[w]->items.push_back(i);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->_stateMutex);
+        this->_task = &task;
+        this->_pendingWorkers = workerCount;
+        this->_generation++;
+    }
+    this->_wakeCondition.notify_all();
+
+    std::unique_lock<std::mutex> lock(this->_stateMutex);
+    this->_doneCondition.wait(lock, [this]() { return this->_pendingWorkers == 0; });
+    this->_task = nullptr;
+}
+
+size_t ThreadPool::defaultThreadCount()
+{
+    unsigned int hardware = std::thread::hardware_concurrency();
+    return hardware > 0 ? hardware : 1;
+}
+
+void ThreadPool::_start(size_t threadCount)
+{
+    this->_stopping = false;
+
+    for (size_t i = 0; i < threadCount; i++)
+        this->_queues.push_back(std::make_unique<WorkQueue>());
+
+    for (size_t i = 0; i < threadCount; i++)
+        this->_workers.emplace_back(&ThreadPool::_workerLoop, this, i, this->_generation);
+}
+
+void ThreadPool::_stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->_stateMutex);
+        this->_stopping = true;
+    }
+    this->_wakeCondition.notify_all();
+
+    for (auto& worker : this->_workers)
+        if (worker.joinable()) worker.join();
+
+    this->_workers.clear();
+    this->_queues.clear();
+}
+
+void ThreadPool::_workerLoop(size_t workerId, size_t seenGeneration)
+{
+    while (true) {
+        const Task* task = nullptr;
+
+        {
+            std::unique_lock<std::mutex> lock(this->_stateMutex);
+            this->_wakeCondition.wait(lock, [this, seenGeneration]() {
+                return this->_stopping || this->_generation != seenGeneration;
+            });
+
+            if (this->_stopping) return;
+
+            seenGeneration = this->_generation;
+            task = this->_task;
+        }
+
+        size_t index;
+        while (this->_nextItem(workerId, index)) (*task)(index, workerId);
+
+        std::lock_guard<std::mutex> lock(this->_stateMutex);
+        if (--this->_pendingWorkers == 0) this->_doneCondition.notify_all();
+    }
+}
+
+bool ThreadPool::_nextItem(size_t workerId, size_t& index)
+{
+    {
+        WorkQueue& own = *this->_queues[workerId];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.items.empty()) {
+            index = own.items.front();
+            own.items.pop_front();
+            return true;
+        }
+    }
+
+    size_t workerCount = this->_queues.size();
+
+    for (size_t offset = 1; offset < workerCount; offset++) {
+        WorkQueue& victim = *this->_queues[(workerId + offset) % workerCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.items.empty()) {
+            index = victim.items.back();
+            victim.items.pop_back();
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,314 @@
+#include "WavefrontTracer.hpp"
+#include "CameraWithLights.hpp"
+#include "Random.hpp"
+
+#include <algorithm>
+
+void WavefrontTracer::clear()
+{
+    for (std::vector<int>* values : {&this->_pixelX, &this->_pixelY, &this->_sample})
+        values->clear();
+
+    for (std::vector<double>* values : {
+            &this->_originX, &this->_originY, &this->_originZ,
+            &this->_directionX, &this->_directionY, &this->_directionZ,
+            &this->_throughputR, &this->_throughputG, &this->_throughputB,
+            &this->_radianceR, &this->_radianceG, &this->_radianceB,
+            &this->_albedoR, &this->_albedoG, &this->_albedoB,
+            &this->_normalX, &this->_normalY, &this->_normalZ,
+            &this->_depth, &this->_coneWidth})
+        values->clear();
+}
+
+void WavefrontTracer::addPath(int x, int y, int sample, const Ray& ray)
+{
+    this->_pixelX.push_back(x);
+    this->_pixelY.push_back(y);
+    this->_sample.push_back(sample);
+
+    this->_originX.push_back(ray.origin().x());
+    this->_originY.push_back(ray.origin().y());
+    this->_originZ.push_back(ray.origin().z());
+    this->_directionX.push_back(ray.direction().x());
+    this->_directionY.push_back(ray.direction().y());
+    this->_directionZ.push_back(ray.direction().z());
+
+    for (std::vector<double>* values : {&this->_throughputR, &this->_throughputG, &this->_throughputB})
+        values->push_back(1.0);
+
+    for (std::vector<double>* values : {
+            &this->_radianceR, &this->_radianceG, &this->_radianceB,
+            &this->_albedoR, &this->_albedoG, &this->_albedoB,
+            &this->_normalX, &this->_normalY, &this->_normalZ,
+            &this->_depth, &this->_coneWidth})
+        values->push_back(0.0);
+}
+
+size_t WavefrontTracer::pathCount() const
+{
+    return this->_pixelX.size();
+}
+
+bool WavefrontTracer::trace(const CameraWithLights& camera, const Hittable& world, uint64_t& rayCount, const std::atomic<bool>* cancelled)
+{
+    Aabb bounds = world.boundingBox();
+
+    this->_active.resize(this->pathCount());
+    for (uint32_t path = 0; path < this->_active.size(); path++)
+        this->_active[path] = path;
+
+    for (int bounce = 0; bounce < camera.maxDepth && !this->_active.empty(); bounce++) {
+        if (cancelled && cancelled->load(std::memory_order_relaxed)) return false;
+
+        // Camera rays are already queued in pixel order, which is as coherent as it gets.
+        if (bounce > 0) this->_sortRays(bounds);
+
+        this->_extend(camera, world, bounce, rayCount);
+        this->_shade(camera, bounce);
+        this->_shadow(world);
+
+        this->_active.swap(this->_next);
+    }
+
+    return true;
+}
+
+Color WavefrontTracer::radiance(size_t path) const
+{
+    return Color(this->_radianceR[path], this->_radianceG[path], this->_radianceB[path]);
+}
+
+Color WavefrontTracer::albedo(size_t path) const
+{
+    return Color(this->_albedoR[path], this->_albedoG[path], this->_albedoB[path]);
+}
+
+Vec3 WavefrontTracer::normal(size_t path) const
+{
+    return Vec3(this->_normalX[path], this->_normalY[path], this->_normalZ[path]);
+}
+
+double WavefrontTracer::depth(size_t path) const
+{
+    return this->_depth[path];
+}
+
+// Orders live rays by direction octant, then by the Morton code of their origin on a
+// 512^3 grid over the scene bounds. The 27-bit code and the octant above it fill the key's
+// upper 30 bits, leaving the lower 32 for the path index.
+void WavefrontTracer::_sortRays(const Aabb& bounds)
+{
+    double scale[3];
+    for (int axis = 0; axis < 3; axis++) {
+        double extent = bounds.axisInterval(axis).size();
+        scale[axis] = extent > 0.0 && std::isfinite(extent) ? 511.0 / extent : 0.0;
+    }
+
+    this->_rayKeys.resize(this->_active.size());
+
+    for (size_t k = 0; k < this->_active.size(); k++) {
+        uint32_t path = this->_active[k];
+        uint32_t octant = (this->_directionX[path] < 0.0 ? 1u : 0u)
+                        | (this->_directionY[path] < 0.0 ? 2u : 0u)
+                        | (this->_directionZ[path] < 0.0 ? 4u : 0u);
+
+        uint32_t cell[3];
+        const double origin[3] = {this->_originX[path], this->_originY[path], this->_originZ[path]};
+        for (int axis = 0; axis < 3; axis++) {
+            double offset = (origin[axis] - bounds.axisInterval(axis).min) * scale[axis];
+            cell[axis] = static_cast<uint32_t>(std::clamp(offset, 0.0, 511.0));
+        }
+
+        uint64_t morton = _spreadBits(cell[0]) | (_spreadBits(cell[1]) << 1) | (_spreadBits(cell[2]) << 2);
+        uint64_t key = (static_cast<uint64_t>(octant) << 27) | morton;
+
+        this->_rayKeys[k] = (key << 32) | path;
+    }
+
+    std::sort(this->_rayKeys.begin(), this->_rayKeys.end());
+
+    for (size_t k = 0; k < this->_active.size(); k++)
+        this->_active[k] = static_cast<uint32_t>(this->_rayKeys[k]);
+}
+
+// Closest hit for every live ray. Misses pick up the background and end here.
+void WavefrontTracer::_extend(const CameraWithLights& camera, const Hittable& world, int bounce, uint64_t& rayCount)
+{
+    size_t count = this->_active.size();
+
+    this->_hits.resize(count);
+    this->_hitFlags.assign(count, 0);
+    rayCount += count;
+
+    for (size_t k = 0; k < count; k++) {
+        uint32_t path = this->_active[k];
+        Ray r = this->_ray(path);
+
+        if (world.hit(r, Interval(0.001, INFINITY), this->_hits[k])) {
+            this->_coneWidth[path] += camera._pixelSpread * this->_hits[k].t * r.direction().length();
+            this->_hits[k].footprint = this->_coneWidth[path];
+            this->_hitFlags[k] = 1;
+            continue;
+        }
+
+        Color background = camera._background(r);
+
+        if (bounce == 0) this->_setFirstHit(path, background, Vec3(0, 0, 0), 0.0);
+        this->_addRadiance(path, this->_throughput(path) * background);
+    }
+}
+
+// Scatters every hit, grouped by material so each material's code and data stay hot, and
+// queues the shadow rays of the selected lights. Mirrors CameraWithLights::_rayColor.
+void WavefrontTracer::_shade(const CameraWithLights& camera, int bounce)
+{
+    const MaterialTable* materials = camera.materials;
+    bool useLights = camera.lights && !camera.lights->lights.empty();
+
+    this->_shadeOrder.clear();
+    for (uint32_t k = 0; k < this->_hitFlags.size(); k++) {
+        if (!this->_hitFlags[k]) continue;
+
+        uint32_t material = this->_hits[k].material;
+        uint64_t kind = materials ? static_cast<uint64_t>(materials->kind(material)) : 0;
+        this->_shadeOrder.push_back({(kind << 32) | material, k});
+    }
+    std::sort(this->_shadeOrder.begin(), this->_shadeOrder.end());
+
+    this->_next.clear();
+    this->_shadowPath.clear();
+    for (std::vector<double>* values : {
+            &this->_shadowOriginX, &this->_shadowOriginY, &this->_shadowOriginZ,
+            &this->_shadowDirectionX, &this->_shadowDirectionY, &this->_shadowDirectionZ,
+            &this->_shadowTMax, &this->_shadowR, &this->_shadowG, &this->_shadowB})
+        values->clear();
+
+    uint64_t bounceSeed = camera.seed ^ 0x5bd1e995ULL ^ ((bounce + 1) * 0x9e3779b97f4a7c15ULL);
+
+    for (const auto& entry : this->_shadeOrder) {
+        uint32_t path = this->_active[entry.second];
+        const HitRecord& rec = this->_hits[entry.second];
+        Ray r = this->_ray(path);
+
+        Random::seed(Sampler::hashPixelSample(bounceSeed, this->_pixelX[path], this->_pixelY[path], this->_sample[path]));
+
+        Ray scattered;
+        Color attenuation;
+        const Materials& material = camera._material(rec);
+        Color emitted = material.emitted();
+        Color throughput = this->_throughput(path);
+
+        bool scatters = material.scatter(r, rec, attenuation, scattered);
+
+        if (bounce == 0) this->_setFirstHit(path, scatters ? attenuation : emitted, rec.normal, rec.t * r.direction().length());
+
+        this->_addRadiance(path, throughput * emitted);
+
+        if (!scatters) continue;
+
+        if (useLights) {
+            Vec3 viewDir = unitVector(-r.direction());
+
+            this->_lightSamples.clear();
+            Color ambient = camera.lights->sampleLighting(rec.p, rec.normal, viewDir, attenuation, 32.0, this->_lightSamples);
+            this->_addRadiance(path, throughput * ambient);
+
+            for (const sceneLights::LightSample& sample : this->_lightSamples) {
+                double tMax;
+                Ray shadowRay = sample.light->shadowRay(rec.p, tMax);
+                Color contribution = throughput * sample.contribution;
+
+                this->_shadowPath.push_back(path);
+                this->_shadowOriginX.push_back(shadowRay.origin().x());
+                this->_shadowOriginY.push_back(shadowRay.origin().y());
+                this->_shadowOriginZ.push_back(shadowRay.origin().z());
+                this->_shadowDirectionX.push_back(shadowRay.direction().x());
+                this->_shadowDirectionY.push_back(shadowRay.direction().y());
+                this->_shadowDirectionZ.push_back(shadowRay.direction().z());
+                this->_shadowTMax.push_back(tMax);
+                this->_shadowR.push_back(contribution.x());
+                this->_shadowG.push_back(contribution.y());
+                this->_shadowB.push_back(contribution.z());
+            }
+
+            throughput = throughput * attenuation * 0.3;
+        } else {
+            throughput = throughput * attenuation;
+        }
+
+        if (camera.russianRoulette && bounce + 1 >= camera.rouletteMinDepth) {
+            double survival = std::clamp(std::max({throughput.x(), throughput.y(), throughput.z()}), 0.0, 0.95);
+
+            if (survival <= 0.0 || Random::uniform() >= survival) continue;
+
+            throughput /= survival;
+        }
+
+        this->_throughputR[path] = throughput.x();
+        this->_throughputG[path] = throughput.y();
+        this->_throughputB[path] = throughput.z();
+        this->_setRay(path, scattered);
+        this->_next.push_back(path);
+    }
+}
+
+void WavefrontTracer::_shadow(const Hittable& world)
+{
+    for (size_t k = 0; k < this->_shadowPath.size(); k++) {
+        Ray shadowRay(point3(this->_shadowOriginX[k], this->_shadowOriginY[k], this->_shadowOriginZ[k]),
+                      Vec3(this->_shadowDirectionX[k], this->_shadowDirectionY[k], this->_shadowDirectionZ[k]));
+
+        if (!world.occluded(shadowRay, Interval(0.001, this->_shadowTMax[k])))
+            this->_addRadiance(this->_shadowPath[k], Color(this->_shadowR[k], this->_shadowG[k], this->_shadowB[k]));
+    }
+}
+
+Ray WavefrontTracer::_ray(uint32_t path) const
+{
+    return Ray(point3(this->_originX[path], this->_originY[path], this->_originZ[path]),
+               Vec3(this->_directionX[path], this->_directionY[path], this->_directionZ[path]));
+}
+
+void WavefrontTracer::_setRay(uint32_t path, const Ray& ray)
+{
+    this->_originX[path] = ray.origin().x();
+    this->_originY[path] = ray.origin().y();
+    this->_originZ[path] = ray.origin().z();
+    this->_directionX[path] = ray.direction().x();
+    this->_directionY[path] = ray.direction().y();
+    this->_directionZ[path] = ray.direction().z();
+}
+
+void WavefrontTracer::_addRadiance(uint32_t path, const Color& color)
+{
+    this->_radianceR[path] += color.x();
+    this->_radianceG[path] += color.y();
+    this->_radianceB[path] += color.z();
+}
+
+Color WavefrontTracer::_throughput(uint32_t path) const
+{
+    return Color(this->_throughputR[path], this->_throughputG[path], this->_throughputB[path]);
+}
+
+void WavefrontTracer::_setFirstHit(uint32_t path, const Color& albedo, const Vec3& normal, double depth)
+{
+    this->_albedoR[path] = albedo.x();
+    this->_albedoG[path] = albedo.y();
+    this->_albedoB[path] = albedo.z();
+    this->_normalX[path] = normal.x();
+    this->_normalY[path] = normal.y();
+    this->_normalZ[path] = normal.z();
+    this->_depth[path] = depth;
+}
+
+// Inserts two zero bits between each of the low ten bits.
+uint32_t WavefrontTracer::_spreadBits(uint32_t value)
+{
+    value &= 0x3ff;
+    value = (value | (value << 16)) & 0x030000ff;
+    value = (value | (value << 8)) & 0x0300f00f;
+    value = (value | (value << 4)) & 0x030c30c3;
+    value = (value | (value << 2)) & 0x09249249;
+    return value;
+}
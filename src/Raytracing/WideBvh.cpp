@@ -0,0 +1,494 @@
+#include "WideBvh.hpp"
+
+#include <atomic>
+#include <functional>
+
+namespace {
+    std::atomic<bool> compressedNodesEnabled{false};
+
+    // Smallest exponent whose 255 grid cells, stepped from lo in float arithmetic, reach hi.
+    // Kept inside the normal float range.
+    int8_t quantizationExponent(float lo, float hi)
+    {
+        int exponent = -126;
+
+        if (hi > lo) {
+            std::frexp((hi - lo) / 255.0f, &exponent);
+            exponent = std::clamp(exponent - 1, -126, 127);
+            while (exponent < 127 && 255.0f * std::ldexp(1.0f, exponent) + lo < hi) exponent++;
+        }
+
+        return static_cast<int8_t>(exponent);
+    }
+
+    float roundDown(double value)
+    {
+        float result = static_cast<float>(value);
+        if (result > value) result = std::nextafter(result, -INFINITY);
+        return result;
+    }
+
+    // SAH cost of reaching a lane: a node test for an interior child, one intersection per
+    // primitive for a leaf.
+    double laneWeight(uint8_t count)
+    {
+        return count > 0 ? LinearBvh::intersectionCost * count : LinearBvh::traversalCost;
+    }
+
+    double laneArea(const float* bounds, int width, int lane)
+    {
+        double dx = bounds[3 * width + lane] - bounds[lane];
+        double dy = bounds[4 * width + lane] - bounds[width + lane];
+        double dz = bounds[5 * width + lane] - bounds[2 * width + lane];
+        return 2.0 * (dx * dy + dy * dz + dz * dx);
+    }
+}
+
+void WideBvh::build(const std::vector<Aabb>& primitiveBounds, ThreadPool* threadPool)
+{
+    auto startTime = std::chrono::steady_clock::now();
+
+    this->clear();
+
+    if (primitiveBounds.empty()) return;
+
+    LinearBvh binary;
+    binary.build(primitiveBounds, threadPool);
+
+    this->_width = Simd::preferredWidth();
+    this->_primitiveCount = primitiveBounds.size();
+    this->_slots.reserve(primitiveBounds.size() + primitiveBounds.size() / 2);
+
+    if (this->_width == 8) {
+        this->_nodes8.reserve(binary.nodeCount() / 4 + 1);
+        this->_collapse(binary, 0, this->_nodes8);
+    } else {
+        this->_nodes4.reserve(binary.nodeCount() / 2 + 1);
+        this->_collapse(binary, 0, this->_nodes4);
+    }
+
+    this->_compressed = compressedNodesEnabled.load(std::memory_order_relaxed);
+
+    if (this->_compressed) {
+        if (this->_width == 8) _quantize(this->_nodes8, this->_quantized8);
+        else _quantize(this->_nodes4, this->_quantized4);
+
+        std::vector<WideBvhNode<4>>().swap(this->_nodes4);
+        std::vector<WideBvhNode<8>>().swap(this->_nodes8);
+    }
+
+    this->_stats = binary.buildStats();
+    this->_stats.nodeCount = this->nodeCount();
+    this->_stats.buildMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void WideBvh::clear()
+{
+    this->_nodes4.clear();
+    this->_nodes8.clear();
+    this->_quantized4.clear();
+    this->_quantized8.clear();
+    this->_slots.clear();
+    this->_primitiveCount = 0;
+    this->_parents.clear();
+    this->_primitiveLeaves.clear();
+    this->_laneCost = 0.0;
+    this->_builtSahCost = 0.0;
+    this->_compressed = false;
+    this->_stats = LinearBvh::BuildStats();
+}
+
+bool WideBvh::empty() const
+{
+    return this->_nodes4.empty() && this->_nodes8.empty() && this->_quantized4.empty() && this->_quantized8.empty();
+}
+
+int WideBvh::width() const
+{
+    return this->_width;
+}
+
+Aabb WideBvh::bounds() const
+{
+    double lo[3] = {INFINITY, INFINITY, INFINITY};
+    double hi[3] = {-INFINITY, -INFINITY, -INFINITY};
+
+    auto accumulate = [&](const float* bounds, int width) {
+        for (int lane = 0; lane < width; lane++) {
+            for (int axis = 0; axis < 3; axis++) {
+                if (bounds[axis * width + lane] > bounds[(axis + 3) * width + lane]) continue;
+                lo[axis] = std::min(lo[axis], static_cast<double>(bounds[axis * width + lane]));
+                hi[axis] = std::max(hi[axis], static_cast<double>(bounds[(axis + 3) * width + lane]));
+            }
+        }
+    };
+
+    // A quantized root is decoded into float rows first.
+    WideBvhNode<8> decoded8;
+    WideBvhNode<4> decoded4;
+
+    if (!this->_nodes8.empty()) accumulate(this->_nodes8[0].bounds, 8);
+    else if (!this->_nodes4.empty()) accumulate(this->_nodes4[0].bounds, 4);
+    else if (!this->_quantized8.empty()) { _unpack(this->_quantized8[0], decoded8); accumulate(decoded8.bounds, 8); }
+    else if (!this->_quantized4.empty()) { _unpack(this->_quantized4[0], decoded4); accumulate(decoded4.bounds, 4); }
+    else return Aabb(point3(0, 0, 0), point3(0, 0, 0));
+
+    return Aabb(point3(lo[0], lo[1], lo[2]), point3(hi[0], hi[1], hi[2]));
+}
+
+size_t WideBvh::nodeCount() const
+{
+    if (this->_compressed) return this->_width == 8 ? this->_quantized8.size() : this->_quantized4.size();
+    return this->_width == 8 ? this->_nodes8.size() : this->_nodes4.size();
+}
+
+size_t WideBvh::nodeMemory() const
+{
+    return this->_nodes4.size() * sizeof(WideBvhNode<4>)
+        + this->_nodes8.size() * sizeof(WideBvhNode<8>)
+        + this->_quantized4.size() * sizeof(QuantizedWideBvhNode<4>)
+        + this->_quantized8.size() * sizeof(QuantizedWideBvhNode<8>);
+}
+
+bool WideBvh::compressed() const
+{
+    return this->_compressed;
+}
+
+const std::vector<uint32_t>& WideBvh::primitiveSlots() const
+{
+    return this->_slots;
+}
+
+const LinearBvh::BuildStats& WideBvh::buildStats() const
+{
+    return this->_stats;
+}
+
+void WideBvh::refit(const std::vector<uint32_t>& changedPrimitives, const std::function<Aabb(uint32_t)>& primitiveBounds)
+{
+    if (this->empty() || changedPrimitives.empty()) return;
+
+    if (this->_compressed) {
+        if (this->_width == 8) this->_refit<8>(this->_quantized8, changedPrimitives, primitiveBounds);
+        else this->_refit<4>(this->_quantized4, changedPrimitives, primitiveBounds);
+    } else {
+        if (this->_width == 8) this->_refit<8>(this->_nodes8, changedPrimitives, primitiveBounds);
+        else this->_refit<4>(this->_nodes4, changedPrimitives, primitiveBounds);
+    }
+}
+
+double WideBvh::sahGrowth() const
+{
+    if (this->_parents.empty() || this->_builtSahCost <= 0.0) return 1.0;
+    return this->_sahCost() / this->_builtSahCost;
+}
+
+// Pulls binary descendants up into one wide node, always opening the interior child with
+// the largest surface area, until Width children are gathered or only leaves remain.
+template <int Width>
+uint32_t WideBvh::_collapse(const LinearBvh& binary, uint32_t binaryIndex, std::vector<WideBvhNode<Width>>& nodes)
+{
+    const std::vector<LinearBvhNode>& binaryNodes = binary.nodes();
+    const std::vector<uint32_t>& primitiveIndices = binary.primitiveIndices();
+
+    auto area = [&](uint32_t index) {
+        const LinearBvhNode& node = binaryNodes[index];
+        double dx = node.boundsMax[0] - node.boundsMin[0];
+        double dy = node.boundsMax[1] - node.boundsMin[1];
+        double dz = node.boundsMax[2] - node.boundsMin[2];
+        return dx * dy + dy * dz + dz * dx;
+    };
+
+    uint32_t children[Width];
+    int childCount = 0;
+
+    if (binaryNodes[binaryIndex].isLeaf()) {
+        children[childCount++] = binaryIndex;
+    } else {
+        children[childCount++] = binaryIndex + 1;
+        children[childCount++] = binaryNodes[binaryIndex].offset;
+    }
+
+    while (childCount < Width) {
+        int best = -1;
+
+        for (int i = 0; i < childCount; i++) {
+            if (binaryNodes[children[i]].isLeaf()) continue;
+            if (best < 0 || area(children[i]) > area(children[best])) best = i;
+        }
+
+        if (best < 0) break;
+
+        uint32_t opened = children[best];
+        children[best] = opened + 1;
+        children[childCount++] = binaryNodes[opened].offset;
+    }
+
+    uint32_t nodeIndex = static_cast<uint32_t>(nodes.size());
+    nodes.emplace_back();
+
+    for (int lane = 0; lane < Width; lane++) {
+        WideBvhNode<Width>& node = nodes[nodeIndex];
+
+        if (lane >= childCount) {
+            for (int axis = 0; axis < 3; axis++) {
+                node.bounds[axis * Width + lane] = INFINITY;
+                node.bounds[(axis + 3) * Width + lane] = -INFINITY;
+            }
+            node.child[lane] = invalidPrimitive;
+            node.count[lane] = 0;
+            continue;
+        }
+
+        const LinearBvhNode& source = binaryNodes[children[lane]];
+
+        for (int axis = 0; axis < 3; axis++) {
+            node.bounds[axis * Width + lane] = source.boundsMin[axis];
+            node.bounds[(axis + 3) * Width + lane] = source.boundsMax[axis];
+        }
+
+        if (source.isLeaf()) {
+            uint32_t first = static_cast<uint32_t>(this->_slots.size());
+
+            for (uint32_t i = 0; i < source.primitiveCount; i++)
+                this->_slots.push_back(primitiveIndices[source.offset + i]);
+            while (this->_slots.size() % Width != 0)
+                this->_slots.push_back(invalidPrimitive);
+
+            node.child[lane] = first;
+            node.count[lane] = static_cast<uint8_t>(source.primitiveCount);
+        } else {
+            uint32_t child = this->_collapse(binary, children[lane], nodes);
+            // nodes may have been reallocated by the recursive call.
+            nodes[nodeIndex].child[lane] = child;
+            nodes[nodeIndex].count[lane] = 0;
+        }
+    }
+
+    return nodeIndex;
+}
+
+// Re-expresses every child box on a byte grid over its parent node's box.
+template <int Width>
+void WideBvh::_quantize(const std::vector<WideBvhNode<Width>>& nodes, std::vector<QuantizedWideBvhNode<Width>>& quantized)
+{
+    quantized.assign(nodes.size(), QuantizedWideBvhNode<Width>());
+
+    for (size_t index = 0; index < nodes.size(); index++)
+        _pack(nodes[index], quantized[index]);
+}
+
+template <int Width>
+void WideBvh::_unpack(const WideBvhNode<Width>& node, WideBvhNode<Width>& unpacked)
+{
+    unpacked = node;
+}
+
+// Decodes a quantized node into float rows with the kernels' arithmetic; empty lanes get
+// inverted bounds again.
+template <int Width>
+void WideBvh::_unpack(const QuantizedWideBvhNode<Width>& node, WideBvhNode<Width>& unpacked)
+{
+    for (int row = 0; row < 6; row++) {
+        int axis = row % 3;
+        float scale = std::ldexp(1.0f, node.exponent[axis]);
+
+        for (int lane = 0; lane < Width; lane++) {
+            unpacked.bounds[row * Width + lane] = (node.validMask & (1 << lane))
+                ? static_cast<float>(node.bounds[row * Width + lane]) * scale + node.origin[axis]
+                : (row < 3 ? INFINITY : -INFINITY);
+        }
+    }
+
+    for (int lane = 0; lane < Width; lane++) {
+        unpacked.child[lane] = node.child[lane];
+        unpacked.count[lane] = node.count[lane];
+    }
+}
+
+template <int Width>
+void WideBvh::_pack(const WideBvhNode<Width>& node, WideBvhNode<Width>& packed)
+{
+    packed = node;
+}
+
+// Lower bounds round down and upper bounds up, checked with the same float arithmetic the
+// kernels use to decode them, so no child ever shrinks.
+template <int Width>
+void WideBvh::_pack(const WideBvhNode<Width>& node, QuantizedWideBvhNode<Width>& packed)
+{
+    packed.validMask = 0;
+    for (int lane = 0; lane < Width; lane++) {
+        packed.child[lane] = node.child[lane];
+        packed.count[lane] = node.count[lane];
+        if (node.bounds[lane] <= node.bounds[3 * Width + lane]) packed.validMask |= 1 << lane;
+    }
+
+    for (int axis = 0; axis < 3; axis++) {
+        float lo = INFINITY;
+        float hi = -INFINITY;
+
+        for (int lane = 0; lane < Width; lane++) {
+            if (!(packed.validMask & (1 << lane))) continue;
+            lo = std::min(lo, node.bounds[axis * Width + lane]);
+            hi = std::max(hi, node.bounds[(axis + 3) * Width + lane]);
+        }
+
+        if (packed.validMask == 0) lo = hi = 0.0f;
+
+        int8_t exponent = quantizationExponent(lo, hi);
+        float scale = std::ldexp(1.0f, exponent);
+
+        packed.origin[axis] = lo;
+        packed.exponent[axis] = exponent;
+
+        for (int lane = 0; lane < Width; lane++) {
+            uint8_t& qLo = packed.bounds[axis * Width + lane];
+            uint8_t& qHi = packed.bounds[(axis + 3) * Width + lane];
+
+            if (!(packed.validMask & (1 << lane))) {
+                qLo = 255;
+                qHi = 0;
+                continue;
+            }
+
+            float childLo = node.bounds[axis * Width + lane];
+            float childHi = node.bounds[(axis + 3) * Width + lane];
+
+            int cellLo = std::clamp(static_cast<int>(std::floor((childLo - lo) / scale)), 0, 255);
+            int cellHi = std::clamp(static_cast<int>(std::ceil((childHi - lo) / scale)), 0, 255);
+
+            while (cellLo > 0 && static_cast<float>(cellLo) * scale + lo > childLo) cellLo--;
+            while (cellHi < 255 && static_cast<float>(cellHi) * scale + lo < childHi) cellHi++;
+
+            qLo = static_cast<uint8_t>(cellLo);
+            qHi = static_cast<uint8_t>(cellHi);
+        }
+    }
+}
+
+// Records each node's parent and each primitive's leaf node, and the lane cost the SAH
+// growth is measured against.
+template <int Width, typename Node>
+void WideBvh::_linkForRefit(const std::vector<Node>& nodes)
+{
+    this->_parents.assign(nodes.size(), invalidPrimitive);
+    this->_primitiveLeaves.assign(this->_primitiveCount, invalidPrimitive);
+    this->_laneCost = 0.0;
+
+    for (size_t index = 0; index < nodes.size(); index++) {
+        WideBvhNode<Width> node;
+        _unpack(nodes[index], node);
+
+        for (int lane = 0; lane < Width; lane++) {
+            if (node.child[lane] == invalidPrimitive) continue;
+
+            this->_laneCost += laneWeight(node.count[lane]) * laneArea(node.bounds, Width, lane);
+
+            if (node.count[lane] == 0) {
+                this->_parents[node.child[lane]] = static_cast<uint32_t>(index);
+                continue;
+            }
+
+            for (uint32_t slot = node.child[lane]; slot < node.child[lane] + node.count[lane]; slot++)
+                this->_primitiveLeaves[this->_slots[slot]] = static_cast<uint32_t>(index);
+        }
+    }
+
+    this->_builtSahCost = this->_sahCost();
+}
+
+// Nodes are stored parents first, so visiting the touched ones by decreasing index refits
+// every child before its parent. Interior lanes take the union of their child's lanes.
+template <int Width, typename Node>
+void WideBvh::_refit(std::vector<Node>& nodes, const std::vector<uint32_t>& changedPrimitives, const std::function<Aabb(uint32_t)>& primitiveBounds)
+{
+    if (this->_parents.empty()) this->_linkForRefit<Width>(nodes);
+
+    std::vector<uint32_t> touched;
+
+    for (uint32_t primitive : changedPrimitives) {
+        for (uint32_t index = this->_primitiveLeaves[primitive]; index != invalidPrimitive; index = this->_parents[index])
+            touched.push_back(index);
+    }
+
+    std::sort(touched.begin(), touched.end(), std::greater<uint32_t>());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+
+    // Lane costs are taken from the stored node, whose boxes a compressed layout rounds.
+    auto laneCost = [](const WideBvhNode<Width>& node) {
+        double cost = 0.0;
+        for (int lane = 0; lane < Width; lane++)
+            if (node.child[lane] != invalidPrimitive) cost += laneWeight(node.count[lane]) * laneArea(node.bounds, Width, lane);
+        return cost;
+    };
+
+    for (uint32_t index : touched) {
+        WideBvhNode<Width> node;
+        _unpack(nodes[index], node);
+        this->_laneCost -= laneCost(node);
+
+        for (int lane = 0; lane < Width; lane++) {
+            if (node.child[lane] == invalidPrimitive) continue;
+
+            double lo[3] = {INFINITY, INFINITY, INFINITY};
+            double hi[3] = {-INFINITY, -INFINITY, -INFINITY};
+
+            if (node.count[lane] > 0) {
+                for (uint32_t slot = node.child[lane]; slot < node.child[lane] + node.count[lane]; slot++) {
+                    Aabb box = primitiveBounds(this->_slots[slot]);
+
+                    for (int axis = 0; axis < 3; axis++) {
+                        lo[axis] = std::min(lo[axis], box.axisInterval(axis).min);
+                        hi[axis] = std::max(hi[axis], box.axisInterval(axis).max);
+                    }
+                }
+            } else {
+                WideBvhNode<Width> child;
+                _unpack(nodes[node.child[lane]], child);
+
+                for (int childLane = 0; childLane < Width; childLane++) {
+                    if (child.child[childLane] == invalidPrimitive) continue;
+
+                    for (int axis = 0; axis < 3; axis++) {
+                        lo[axis] = std::min(lo[axis], static_cast<double>(child.bounds[axis * Width + childLane]));
+                        hi[axis] = std::max(hi[axis], static_cast<double>(child.bounds[(axis + 3) * Width + childLane]));
+                    }
+                }
+            }
+
+            for (int axis = 0; axis < 3; axis++) {
+                node.bounds[axis * Width + lane] = roundDown(lo[axis]);
+                node.bounds[(axis + 3) * Width + lane] = _roundUp(hi[axis]);
+            }
+        }
+
+        _pack(node, nodes[index]);
+        _unpack(nodes[index], node);
+        this->_laneCost += laneCost(node);
+    }
+}
+
+double WideBvh::_sahCost() const
+{
+    double rootArea = this->bounds().area();
+    return LinearBvh::traversalCost + (rootArea > 0.0 ? this->_laneCost / rootArea : this->_laneCost);
+}
+
+void WideBvh::setCompressedNodes(bool compressed)
+{
+    compressedNodesEnabled.store(compressed, std::memory_order_relaxed);
+}
+
+bool WideBvh::compressedNodes()
+{
+    return compressedNodesEnabled.load(std::memory_order_relaxed);
+}
+
+float WideBvh::_roundUp(double value)
+{
+    float result = static_cast<float>(value);
+    if (result < value) result = std::nextafter(result, INFINITY);
+    return result;
+}
@@ -43,6 +43,7 @@ void PrimitiveSystem::generateMeshes() {
         else if (ParametricCurve* curve = this->_registry.getComponent<ParametricCurve>(id)) {
             render->mesh = this->_generateParametricCurveMesh(*curve, id);
         }
+        render->markMeshChanged();
 
         if (render->material && this->_resourceManager && !render->material->illuminationShader) {
             render->material->illuminationShader = this->_resourceManager->getDefaultIlluminationShader();
@@ -519,6 +520,7 @@ void PrimitiveSystem::_updateDelaunayFromControlPoints(EntityID delaunayId, Dela
     Renderable* render = this->_registry.getComponent<Renderable>(delaunayId);
     if (render) {
         render->mesh = this->_generateDelaunayMesh(delaunay, delaunayId);
+        render->markMeshChanged();
     }
 }
 
@@ -586,6 +588,7 @@ void PrimitiveSystem::_updateCurveFromControlPoints(EntityID curveId, Parametric
     Renderable* render = this->_registry.getComponent<Renderable>(curveId);
     if (render) {
         render->mesh = this->_generateParametricCurveMesh(curve, curveId);
+        render->markMeshChanged();
     }
 }
 
@@ -765,6 +768,7 @@ void PrimitiveSystem::regenerateMesh(EntityID entityId)
     else if (ParametricCurve* curve = this->_registry.getComponent<ParametricCurve>(entityId)) {
         render->mesh = this->_generateParametricCurveMesh(*curve, entityId);
     }
+    render->markMeshChanged();
 }
 
 void PrimitiveSystem::applyDisplacement(EntityID entityId)
@@ -851,6 +855,7 @@ void PrimitiveSystem::applyDisplacement(EntityID entityId)
     }
 
     renderable->mesh = subdividedMesh;
+    renderable->markMeshChanged();
     displacement->needsRegeneration = false;
 }
 
@@ -1,7 +1,7 @@
 #include "RenderSystem.hpp"
 
 RenderSystem::RenderSystem(ComponentRegistry& registry, EntityManager& entityMgr)
-    : _registry(registry), _entityManager(entityMgr)
+    : _registry(registry), _entityManager(entityMgr), _raytracingScene(registry, entityMgr)
 {
     this->_initSkybox();
     this->loadCubemap("cubemaps/parc");
@@ -387,7 +387,10 @@ void RenderSystem::loadCubemap(const std::string& folderPath)
     if (!success)
         ofLogError("RenderSystem") << "Failed to load cubemap from: " << folderPath;
 
+    // The background trace samples the skybox; stop it before replacing the images.
+    this->_raytracingJob.cancel();
     this->_skyboxSampler.loadFromFolder(folderPath);
+    this->resetRaytracingAccumulation();
 }
 
 void RenderSystem::_initWhiteTexture()
@@ -405,6 +408,45 @@ void RenderSystem::setup(CameraManager& cameraManager, SelectionSystem& selectio
     this->_selectionSystem = &selectionSystem;
 }
 
+void RenderSystem::enableRaytracing(bool enable)
+{
+    this->_raytracingEnabled = enable;
+
+    if (!enable) this->_raytracingJob.cancel();
+    this->resetRaytracingAccumulation();
+}
+
+void RenderSystem::setRaytracingThreadCount(size_t threadCount)
+{
+    if (threadCount == this->_raytracingThreadPool.size()) return;
+
+    this->_raytracingJob.cancel();
+    this->_raytracingThreadPool.resize(threadCount);
+    this->resetRaytracingAccumulation();
+}
+
+size_t RenderSystem::getRaytracingThreadCount() const
+{
+    return this->_raytracingThreadPool.size();
+}
+
+void RenderSystem::setRaytracingSimdLevel(SimdLevel level)
+{
+    if (level == Simd::activeLevel()) return;
+
+    // BVH width follows the SIMD level, so rebuild everything with the new one.
+    Simd::setMaxLevel(level);
+    this->_raytracingScene.clear();
+}
+
+void RenderSystem::setRaytracingCompressedBvh(bool compressed)
+{
+    if (compressed == WideBvh::compressedNodes()) return;
+
+    WideBvh::setCompressedNodes(compressed);
+    this->_raytracingScene.clear();
+}
+
 void RenderSystem::_drawBoundingBox(EntityID entityId, const Transform& transform, const BoundingBoxVisualization& bboxVis)
 {
     ofPushStyle();
@@ -598,16 +640,11 @@ void RenderSystem::_renderRaytracing()
     if (!activeCamera || !camTransform) return;
 
     this->_collectSceneLights();
-    this->_raytracingCamera.lights = &this->_sceneLights;
     this->_raytracingCamera.skybox = &this->_skyboxSampler;
+    this->_raytracingCamera.threadPool = &this->_raytracingThreadPool;
 
-    HittableList world;
-    this->_buildRaytracingScene(world);
-
-    this->_raytracingCamera.aspectRatio = 16.0 / 9.0;
-    this->_raytracingCamera.imageWidth = 400;
-    this->_raytracingCamera.samplesPerPixel = 4;
-    this->_raytracingCamera.maxDepth = 8;
+    this->_raytracingScene.setThreadPool(&this->_raytracingThreadPool);
+    this->_raytracingScene.update();
 
     this->_raytracingCamera.lookFrom = point3(camTransform->position.x, camTransform->position.y, camTransform->position.z);
 
@@ -630,20 +667,29 @@ void RenderSystem::_renderRaytracing()
     if (!activeCamera->isOrtho) this->_raytracingCamera.vfov = activeCamera->fov;
     else this->_raytracingCamera.vfov = 60.0;
 
-    if (world.objects.empty()) {
-        this->_raytracingCamera.render(world, this->_raytracingPixels);
-    } else {
-        Bvh bvh_tree(world);
-        this->_raytracingCamera.render(bvh_tree, this->_raytracingPixels);
+    // Restart the background trace whenever its inputs change; until the new tiles
+    // arrive the viewport keeps showing the previous image.
+    uint64_t stateHash = this->_hashRaytracingState();
+    bool moving = stateHash != this->_raytracingStateHash;
+
+    RaytracingQuality::Settings settings = this->_raytracingQuality.update(
+        moving, ofGetWidth(), ofGetHeight(), this->_raytracingJob.raysPerSecond(), this->_raytracingJob.raysPerPath());
+
+    if (moving || settings != this->_raytracingSettings || this->_raytracingRestartRequested) {
+        this->_raytracingCamera.aspectRatio = static_cast<double>(std::max(1, ofGetWidth())) / std::max(1, ofGetHeight());
+        this->_raytracingCamera.imageWidth = settings.width;
+        this->_raytracingCamera.samplesPerPixel = settings.samplesPerPixel;
+        this->_raytracingCamera.maxDepth = settings.maxDepth;
+
+        this->_raytracingJob.start(this->_raytracingCamera, this->_sceneLights, this->_raytracingScene.snapshot(), this->_raytracingMaxSamples,
+            this->_raytracingDenoise ? &this->_raytracingDenoiser : nullptr);
+        this->_raytracingStateHash = stateHash;
+        this->_raytracingSettings = settings;
+        this->_raytracingRestartRequested = false;
     }
 
-    int width = this->_raytracingCamera.imageWidth;
-    int height = int(width / this->_raytracingCamera.aspectRatio);
-
-    if (!_raytracingTexture.isAllocated())
-        this->_raytracingTexture.allocate(width, height, GL_RGB);
-
-    this->_raytracingTexture.loadData(this->_raytracingPixels.data(), width, height, GL_RGB);
+    this->_resizeRaytracingTexture(this->_raytracingCamera.imageWidth, this->_raytracingCamera.imageHeight());
+    this->_uploadRaytracingTiles();
 
     glDisable(GL_DEPTH_TEST);
     glDisable(GL_LIGHTING);
@@ -653,151 +699,80 @@ void RenderSystem::_renderRaytracing()
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
 
+    // Tiles not traced yet at the new resolution are transparent and show the
+    // previous image, upscaled like the current one.
+    ofEnableAlphaBlending();
+    if (this->_raytracingPreviousTexture.isAllocated())
+        this->_raytracingPreviousTexture.draw(0, 0, ofGetWidth(), ofGetHeight());
     this->_raytracingTexture.draw(0, 0, ofGetWidth(), ofGetHeight());
+    ofDisableAlphaBlending();
 }
 
-void RenderSystem::_buildRaytracingScene(HittableList& world)
+void RenderSystem::_resizeRaytracingTexture(int width, int height)
 {
-    for (EntityID id : this->_entityManager.getAllEntities()) {
-        Transform* transform = this->_registry.getComponent<Transform>(id);
-        Renderable* render = this->_registry.getComponent<Renderable>(id);
-
-        if (!transform || !render || !render->visible) continue;
-
-        std::shared_ptr<Materials> mat;
-
-        if (render->material) {
-            glm::vec3 emissive = render->material->emissiveReflection;
-            bool isEmissive = emissive.r > 0.01 || emissive.g > 0.01 || emissive.b > 0.01;
-
-            if (isEmissive) {
-                Color emitColor(
-                    emissive.r * (render->color.r / 255.0),
-                    emissive.g * (render->color.g / 255.0),
-                    emissive.b * (render->color.b / 255.0)
-                );
-                mat = std::make_shared<DiffuseLight>(emitColor);
-            } else {
-                glm::vec3 diffuse = render->material->diffuseReflection;
-                Color diffuseColor(diffuse.r, diffuse.g, diffuse.b);
-
-                diffuseColor = Color(
-                    diffuseColor.x() * (render->color.r / 255.0),
-                    diffuseColor.y() * (render->color.g / 255.0),
-                    diffuseColor.z() * (render->color.b / 255.0)
-                );
-
-                bool hasRefraction = render->material->refractionIndex > 1.01 && render->material->refractionIndex < 3.0;
-                bool usingPBRWorkflow = render->material->metallic > 0.01;
-
-                if (hasRefraction) {
-                    mat = std::make_shared<Dielectric>(render->material->refractionIndex);
-                } else if (usingPBRWorkflow) {
-                    if (render->material->metallic > 0.5) {
-                        glm::vec3 tint = render->material->reflectionTint;
-                        Color reflColor(tint.r * diffuseColor.x(), tint.g * diffuseColor.y(), tint.b * diffuseColor.z());
-                        double fuzz = render->material->roughness;
-                        mat = std::make_shared<Metal>(reflColor, fuzz, render->material->texture);
-                    } else {
-                        mat = std::make_shared<Lambertian>(diffuseColor, render->material->texture);
-                    }
-                } else {
-                    if (render->material->reflectivity > 0.1) {
-                        glm::vec3 tint = render->material->reflectionTint;
-                        Color reflColor(tint.r * diffuseColor.x(), tint.g * diffuseColor.y(), tint.b * diffuseColor.z());
-                        double fuzz = 1.0 - render->material->reflectivity;
-                        mat = std::make_shared<Metal>(reflColor, fuzz, render->material->texture);
-                    } else {
-                        mat = std::make_shared<Lambertian>(diffuseColor, render->material->texture);
-                    }
-                }
-            }
-        } else {
-            Color albedo(render->color.r / 255.0, render->color.g / 255.0, render->color.b / 255.0);
-            mat = std::make_shared<Lambertian>(albedo, nullptr);
-        }
-
-        Sphere* sphereComp = this->_registry.getComponent<Sphere>(id);
-        if (sphereComp) {
-            glm::vec3 center = glm::vec3(transform->matrix * glm::vec4(0, 0, 0, 1));
-            glm::vec3 scale = transform->scale;
-            double radius = sphereComp->radius * std::max({scale.x, scale.y, scale.z});
-
-            auto rtSphere = std::make_shared<Spheres>(
-                point3(center.x, center.y, center.z),
-                radius,
-                mat
-            );
-            world.add(rtSphere);
-            continue;
-        }
+    if (this->_raytracingTexture.isAllocated() && this->_raytracingTexture.getWidth() == width && this->_raytracingTexture.getHeight() == height)
+        return;
 
-        if (render->mesh.getNumVertices() > 0)
-            this->_convertMeshToRaytracing(render->mesh, transform->matrix, mat, world);
-    }
+    if (this->_raytracingTexture.isAllocated())
+        std::swap(this->_raytracingTexture, this->_raytracingPreviousTexture);
 
+    std::vector<unsigned char> transparent(static_cast<size_t>(width) * height * 4, 0);
+    this->_raytracingTexture.allocate(width, height, GL_RGBA);
+    this->_raytracingTexture.loadData(transparent.data(), width, height, GL_RGBA);
 }
 
-int RenderSystem::_convertMeshToRaytracing(
-    const ofMesh& ofMesh,
-    const glm::mat4& transform,
-    std::shared_ptr<Materials> mat,
-    HittableList& world)
+// Uploads only the tiles the background trace finished since the last frame.
+void RenderSystem::_uploadRaytracingTiles()
 {
-    const auto& vertices = ofMesh.getVertices();
-    const auto& indices = ofMesh.getIndices();
+    this->_raytracingJob.takeTileUpdates(this->_raytracingTileUpdates);
 
-    if (vertices.size() == 0) return 0;
+    if (this->_raytracingTileUpdates.empty()) return;
 
-    auto RtMesh = std::make_shared<Mesh>(mat);
-    int triangle_count = 0;
+    const ofTextureData& textureData = this->_raytracingTexture.getTextureData();
 
-    if (indices.size() > 0) {
-        for (size_t i = 0; i < indices.size(); i += 3) {
-            if (i + 2 >= indices.size()) break;
+    glBindTexture(textureData.textureTarget, textureData.textureID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-            glm::vec3 v0_local = vertices[indices[i]];
-            glm::vec3 v1_local = vertices[indices[i + 1]];
-            glm::vec3 v2_local = vertices[indices[i + 2]];
-
-            glm::vec4 v0_world = transform * glm::vec4(v0_local, 1.0);
-            glm::vec4 v1_world = transform * glm::vec4(v1_local, 1.0);
-            glm::vec4 v2_world = transform * glm::vec4(v2_local, 1.0);
-
-            point3 p0(v0_world.x, v0_world.y, v0_world.z);
-            point3 p1(v1_world.x, v1_world.y, v1_world.z);
-            point3 p2(v2_world.x, v2_world.y, v2_world.z);
-
-            RtMesh->addTriangle(p0, p1, p2);
-            triangle_count++;
-        }
-    } else if (vertices.size() >= 3) {
-        for (size_t i = 0; i < vertices.size(); i += 3) {
-            if (i + 2 >= vertices.size()) break;
-
-            glm::vec3 v0_local = vertices[i];
-            glm::vec3 v1_local = vertices[i + 1];
-            glm::vec3 v2_local = vertices[i + 2];
-
-            glm::vec4 v0_world = transform * glm::vec4(v0_local, 1.0);
-            glm::vec4 v1_world = transform * glm::vec4(v1_local, 1.0);
-            glm::vec4 v2_world = transform * glm::vec4(v2_local, 1.0);
-
-            point3 p0(v0_world.x, v0_world.y, v0_world.z);
-            point3 p1(v1_world.x, v1_world.y, v1_world.z);
-            point3 p2(v2_world.x, v2_world.y, v2_world.z);
-
-            RtMesh->addTriangle(p0, p1, p2);
-            triangle_count++;
-        }
+    for (const RaytracingJob::TileUpdate& update : this->_raytracingTileUpdates) {
+        glTexSubImage2D(textureData.textureTarget, 0, update.x, update.y, update.width, update.height,
+            GL_RGB, GL_UNSIGNED_BYTE, update.pixels.data());
     }
 
-    if (triangle_count > 0) {
-        RtMesh->buildBVH();
-        world.add(RtMesh);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(textureData.textureTarget, 0);
+}
+
+// Everything the raytraced image depends on apart from the quality settings; a change
+// restarts progressive accumulation and counts as motion for the quality controller.
+uint64_t RenderSystem::_hashRaytracingState() const
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    const CameraWithLights& camera = this->_raytracingCamera;
+
+    RaytracingScene::hashBytes(hash, &camera.lookFrom, sizeof(camera.lookFrom));
+    RaytracingScene::hashBytes(hash, &camera.lookAt, sizeof(camera.lookAt));
+    RaytracingScene::hashBytes(hash, &camera.vup, sizeof(camera.vup));
+    RaytracingScene::hashBytes(hash, &camera.vfov, sizeof(camera.vfov));
+    RaytracingScene::hashBytes(hash, &camera.seed, sizeof(camera.seed));
+    RaytracingScene::hashBytes(hash, &camera.samplerType, sizeof(camera.samplerType));
+
+    bool skyboxLoaded = this->_skyboxSampler.isLoaded();
+    RaytracingScene::hashBytes(hash, &skyboxLoaded, sizeof(skyboxLoaded));
+
+    uint64_t sceneGeneration = this->_raytracingScene.generation();
+    RaytracingScene::hashBytes(hash, &sceneGeneration, sizeof(sceneGeneration));
+
+    for (const RtLight& light : this->_sceneLights.lights) {
+        RaytracingScene::hashBytes(hash, &light.type, sizeof(light.type));
+        RaytracingScene::hashBytes(hash, &light.position, sizeof(light.position));
+        RaytracingScene::hashBytes(hash, &light.direction, sizeof(light.direction));
+        RaytracingScene::hashBytes(hash, &light.colorValue, sizeof(light.colorValue));
+        RaytracingScene::hashBytes(hash, &light.intensity, sizeof(light.intensity));
+        RaytracingScene::hashBytes(hash, &light.spotAngle, sizeof(light.spotAngle));
+        RaytracingScene::hashBytes(hash, &light.attenuation, sizeof(light.attenuation));
     }
 
-    return triangle_count;
+    return hash;
 }
 
 void RenderSystem::_collectSceneLights()
@@ -830,4 +805,6 @@ void RenderSystem::_collectSceneLights()
             }
         }
     }
+
+    this->_sceneLights.buildSamplingTable();
 }
@@ -85,6 +85,7 @@ void InstructionsPanel::render()
             ImGui::BulletText("BVH acceleration for meshes");
             ImGui::BulletText("Materials: Lambertian, Metal, Dielectric");
             ImGui::BulletText("Skybox sampling for background");
+            ImGui::BulletText("Multi-threaded tile rendering (Raytracing Settings)");
             ImGui::Spacing();
         }
 
@@ -211,6 +211,7 @@ void MaterialPanel::_loadFile(EntityID entityId, Renderable* primaryRenderable,
             if (type.compare("MESH") == 0 ) {
                 ofMesh& newMesh = this->_resourceManager.loadMesh(path);
                 primaryRenderable->mesh = newMesh;
+                primaryRenderable->markMeshChanged();
 
                 primaryRenderable->isPrimitive = false;
 
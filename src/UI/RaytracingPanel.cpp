@@ -0,0 +1,115 @@
+#include "UI/RaytracingPanel.hpp"
+
+RaytracingPanel::RaytracingPanel(RenderSystem& renderSystem) : _renderSystem(renderSystem) {}
+
+void RaytracingPanel::render()
+{
+    if (ImGui::Begin("Raytracing Settings", nullptr, ImGuiWindowFlags_NoCollapse)) {
+
+        ImGui::Text("CPU Raytracer");
+        ImGui::Separator();
+        ImGui::Spacing();
+
+        int threadCount = static_cast<int>(this->_renderSystem.getRaytracingThreadCount());
+        int maxThreads = static_cast<int>(ThreadPool::defaultThreadCount());
+
+        if (ImGui::SliderInt("Threads", &threadCount, 1, std::max(1, maxThreads)))
+            this->_renderSystem.setRaytracingThreadCount(static_cast<size_t>(threadCount));
+
+        const char* samplerTypes[] = {"Independent (PCG32)", "Stratified", "Sobol (Owen scrambled)"};
+        int samplerIndex = static_cast<int>(this->_renderSystem.getRaytracingSampler());
+
+        if (ImGui::Combo("Sampler", &samplerIndex, samplerTypes, IM_ARRAYSIZE(samplerTypes)))
+            this->_renderSystem.setRaytracingSampler(static_cast<SamplerType>(samplerIndex));
+
+        const char* simdLevels[] = {"Scalar", "SSE4.2 (BVH4)", "AVX2 (BVH8)"};
+        int simdIndex = static_cast<int>(this->_renderSystem.getRaytracingSimdLevel());
+        int detectedIndex = static_cast<int>(Simd::detectedLevel());
+
+        if (ImGui::Combo("SIMD", &simdIndex, simdLevels, detectedIndex + 1))
+            this->_renderSystem.setRaytracingSimdLevel(static_cast<SimdLevel>(simdIndex));
+
+        bool compressedBvh = this->_renderSystem.isRaytracingCompressedBvh();
+
+        if (ImGui::Checkbox("Compressed BVH nodes", &compressedBvh))
+            this->_renderSystem.setRaytracingCompressedBvh(compressedBvh);
+
+        const char* lightSamplingModes[] = {"All lights", "Power (alias table)", "Resampled"};
+        int lightSamplingIndex = static_cast<int>(this->_renderSystem.getRaytracingLightSampling());
+
+        if (ImGui::Combo("Light sampling", &lightSamplingIndex, lightSamplingModes, IM_ARRAYSIZE(lightSamplingModes)))
+            this->_renderSystem.setRaytracingLightSampling(static_cast<LightSampling>(lightSamplingIndex));
+
+        bool roulette = this->_renderSystem.isRaytracingRussianRoulette();
+
+        if (ImGui::Checkbox("Russian roulette", &roulette))
+            this->_renderSystem.setRaytracingRussianRoulette(roulette);
+
+        if (roulette) {
+            int minDepth = this->_renderSystem.getRaytracingRouletteMinDepth();
+
+            if (ImGui::SliderInt("Roulette after bounce", &minDepth, 1, 8))
+                this->_renderSystem.setRaytracingRouletteMinDepth(minDepth);
+        }
+
+        float frameBudget = static_cast<float>(this->_renderSystem.getRaytracingFrameBudget());
+
+        if (ImGui::SliderFloat("Frame budget (ms)", &frameBudget, 8.0f, 200.0f, "%.0f"))
+            this->_renderSystem.setRaytracingFrameBudget(frameBudget);
+
+        const RaytracingQuality::Settings& settings = this->_renderSystem.getRaytracingSettings();
+        const RaytracingQuality& quality = this->_renderSystem.getRaytracingQuality();
+
+        ImGui::Text("Resolution: %dx%d (%s)", settings.width, settings.height, quality.settled() ? "full" : "interactive");
+        ImGui::Text("Pass: %d spp, depth %d, %.1f Mrays/s", settings.samplesPerPixel, settings.maxDepth, quality.raysPerSecond() * 1e-6);
+        ImGui::Text("Average path length: %.2f rays", this->_renderSystem.getRaytracingAveragePathLength());
+
+        const RaytracingScene::Stats& sceneStats = this->_renderSystem.getRaytracingSceneStats();
+
+        ImGui::Spacing();
+        ImGui::Separator();
+        ImGui::Text("BVH build: %.2f ms (%zu nodes, %zu triangles, %zu spheres)", sceneStats.bvhBuildMilliseconds, sceneStats.bvhNodeCount, sceneStats.triangleCount, sceneStats.sphereCount);
+        ImGui::Text("BVH nodes: %.2f MB rebuilt", sceneStats.bvhNodeBytes / (1024.0 * 1024.0));
+        ImGui::Text("Top-level SAH cost: %.2f", sceneStats.topLevelSahCost);
+        ImGui::Text("Refit: %.1f us (SAH x%.2f, rebuilt past x%.2f)", sceneStats.refitMicroseconds, sceneStats.sahGrowth, RaytracingScene::rebuildSahGrowth);
+        ImGui::Text("Cached meshes: %zu (%.1f MB rebuilt)", sceneStats.cachedMeshCount, sceneStats.meshMemoryBytes / (1024.0 * 1024.0));
+        ImGui::Text("Materials: %zu (%.1f MB of textures)", sceneStats.materialCount, sceneStats.textureMemoryBytes / (1024.0 * 1024.0));
+
+        ImGui::Spacing();
+        ImGui::Separator();
+        ImGui::Text("Accumulated samples: %d spp", this->_renderSystem.getRaytracingSampleCount());
+
+        bool denoise = this->_renderSystem.isRaytracingDenoise();
+
+        if (ImGui::Checkbox("Denoise", &denoise))
+            this->_renderSystem.setRaytracingDenoise(denoise);
+
+        int maxSamples = this->_renderSystem.getRaytracingMaxSamples();
+
+        if (ImGui::SliderInt("Max samples", &maxSamples, 16, 8192))
+            this->_renderSystem.setRaytracingMaxSamples(maxSamples);
+
+        bool adaptive = this->_renderSystem.isRaytracingAdaptiveSampling();
+
+        if (ImGui::Checkbox("Adaptive sampling", &adaptive))
+            this->_renderSystem.setRaytracingAdaptiveSampling(adaptive);
+
+        if (adaptive) {
+            float threshold = static_cast<float>(this->_renderSystem.getRaytracingNoiseThreshold());
+
+            if (ImGui::SliderFloat("Noise threshold", &threshold, 0.001f, 0.05f, "%.3f"))
+                this->_renderSystem.setRaytracingNoiseThreshold(threshold);
+
+            bool heatMap = this->_renderSystem.isRaytracingSampleHeatMap();
+
+            if (ImGui::Checkbox("Sample heat map", &heatMap))
+                this->_renderSystem.setRaytracingSampleHeatMap(heatMap);
+
+            ImGui::Text("Converged: %.0f%%", this->_renderSystem.getRaytracingConvergedFraction() * 100.0);
+        }
+
+        if (ImGui::Button("Restart Accumulation"))
+            this->_renderSystem.resetRaytracingAccumulation();
+    }
+    ImGui::End();
+}